@@ -0,0 +1,75 @@
+#include "Corpora.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "IRGenerator.hpp"
+#include "Assembler.hpp"
+
+#include <sstream>
+
+static std::unique_ptr<AST> parse(const Corpus& corpus) {
+    std::ostringstream dump;
+    Lexer lexer = Lexer(corpus.sourceCode);
+    TokenStream tokens = TokenStream(lexer, dump);
+    return Parser(tokens).parse();
+}
+
+static size_t countDefinedFunctions(llvm::Module* module) {
+    size_t count = 0;
+    for (const auto& function : *module) {
+        count += !function.isDeclaration();
+    }
+    return count;
+}
+
+static void BM_IRGenerator(benchmark::State& state) {
+    const Corpus& corpus = getCorpora()[state.range(0)];
+    size_t functionCount = 0;
+
+    for (auto _ : state) {
+        // NOTE: Codegen rewrites parts of AST, so every iteration gets a fresh one
+        state.PauseTiming();
+        std::unique_ptr<AST> tree = parse(corpus);
+        state.ResumeTiming();
+
+        IRGenerator codeGenerator = IRGenerator(corpus.name.c_str(), tree);
+        codeGenerator.generateIRCode();
+
+        state.PauseTiming();
+        functionCount = countDefinedFunctions(codeGenerator.getModule());
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(corpus.name);
+    state.counters["functions"] = benchmark::Counter(state.iterations() * functionCount, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_IRGenerator)->Apply(forEachCorpus);
+
+// Whole pipeline from merged source to object in memory, second argument is optimization level
+static void BM_EmitObject(benchmark::State& state) {
+    const Corpus& corpus = getCorpora()[state.range(0)];
+    const OptimizationLevel OPT_LEVELS[] = { OptimizationLevel::O0, OptimizationLevel::O1, OptimizationLevel::O2, OptimizationLevel::O3 };
+    CodeGenOptions options;
+    options.optLevel = OPT_LEVELS[state.range(1)];
+    Assembler::initializeTargets();
+    size_t objectSize = 0;
+
+    for (auto _ : state) {
+        std::unique_ptr<AST> tree = parse(corpus);
+        IRGenerator codeGenerator = IRGenerator(corpus.name.c_str(), tree);
+        codeGenerator.generateIRCode();
+
+        std::vector<ObjectBuffer> objectBuffers;
+        Assembler(options).compileToObjectBuffers(&objectBuffers, codeGenerator.getModule());
+        objectSize = objectBuffers.empty() ? 0 : objectBuffers.front().size();
+    }
+
+    state.SetLabel(corpus.name + " -O" + std::to_string(state.range(1)));
+    state.SetBytesProcessed(state.iterations() * corpus.sourceCode.size());
+    state.counters["objectBytes"] = objectSize;
+}
+BENCHMARK(BM_EmitObject)->Apply([](benchmark::internal::Benchmark* benchmark) {
+    for (size_t i = 0; i < CORPUS_COUNT; i++) {
+        benchmark->Args({ static_cast<int64_t>(i), 0 });
+        benchmark->Args({ static_cast<int64_t>(i), 2 });
+    }
+})->Unit(benchmark::kMillisecond);
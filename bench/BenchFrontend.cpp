@@ -0,0 +1,143 @@
+#include "Corpora.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "Preprocessor.hpp"
+#include "RomanNumber.hpp"
+
+#include <sstream>
+
+static size_t countNodes(const AST* tree) {
+    std::ostringstream treeStream;
+    tree->printTree(treeStream, "", true);
+    const std::string treeString = treeStream.str();
+    return std::count(treeString.begin(), treeString.end(), '\n'); // one line per node
+}
+
+static void BM_Lexer(benchmark::State& state) {
+    const Corpus& corpus = getCorpora()[state.range(0)];
+    std::ostringstream dump;
+    size_t tokenCount = 0;
+
+    for (auto _ : state) {
+        std::vector<Token> tokens;
+        Lexer(corpus.sourceCode).tokenize(tokens, dump);
+        tokenCount = tokens.size();
+        benchmark::DoNotOptimize(tokens.data());
+    }
+
+    state.SetLabel(corpus.name);
+    state.SetBytesProcessed(state.iterations() * corpus.sourceCode.size());
+    state.counters["tokens"] = benchmark::Counter(state.iterations() * tokenCount, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Lexer)->Apply(forEachCorpus);
+
+// kernel alone on long run, as in long comment
+static void BM_LexerScan(benchmark::State& state) {
+    const auto level = static_cast<lexer_scan::SimdLevel>(state.range(0));
+    if (level > lexer_scan::getSimdLevel()) {
+        state.SkipWithError("not supported by CPU");
+        return;
+    }
+    std::u8string text(64 * 1024, u8'a');
+    text.back() = u8'\n';
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lexer_scan::findFirstOf(text.data(), text.data() + text.size(), lexer_scan::LINE_ENDS, level));
+    }
+
+    const char* LEVEL_LABELS[] = { "scalar", "ssse3", "avx2" };
+    state.SetLabel(LEVEL_LABELS[state.range(0)]);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_LexerScan)->DenseRange(0, 2);
+
+static void BM_Parser(benchmark::State& state) {
+    const Corpus& corpus = getCorpora()[state.range(0)];
+    std::ostringstream dump;
+    std::vector<Token> tokens;
+    Lexer(corpus.sourceCode).tokenize(tokens, dump);
+    size_t nodeCount = 0;
+
+    for (auto _ : state) {
+        TokenStream stream = TokenStream(tokens);
+        Parser parser = Parser(stream);
+        std::unique_ptr<AST> tree = parser.parse();
+        
+        state.PauseTiming();
+        nodeCount = countNodes(tree.get());
+        tree.reset(); // freeing AST isn't part of parsing
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(corpus.name);
+    state.counters["nodes"] = benchmark::Counter(state.iterations() * nodeCount, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Parser)->Apply(forEachCorpus);
+
+// parser pulling tokens from lexer, as the compiler does
+static void BM_LexerParser(benchmark::State& state) {
+    const Corpus& corpus = getCorpora()[state.range(0)];
+    std::ostringstream dump;
+
+    for (auto _ : state) {
+        Lexer lexer = Lexer(corpus.sourceCode);
+        TokenStream tokens = TokenStream(lexer, dump);
+        std::unique_ptr<AST> tree = Parser(tokens).parse();
+        benchmark::DoNotOptimize(tree.get());
+
+        state.PauseTiming();
+        tree.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(corpus.name);
+    state.SetBytesProcessed(state.iterations() * corpus.sourceCode.size());
+}
+BENCHMARK(BM_LexerParser)->Apply(forEachCorpus);
+
+static void BM_Preprocessor(benchmark::State& state) {
+    const size_t fanOut = state.range(0);
+    const std::filesystem::path mainFilePath = fanOut == 0 
+        ? std::filesystem::path(LSC_SOURCE_DIR) / "examples" / "binarytree.lorem"
+        : writeIncludeTree(fanOut);
+
+    for (auto _ : state) {
+        Preprocessor preprocessor = Preprocessor(mainFilePath);
+        benchmark::DoNotOptimize(preprocessor.getMergedSourceCode());
+    }
+
+    state.SetLabel(fanOut == 0 ? "binarytree" : "fan-out " + std::to_string(fanOut));
+    state.counters["files"] = benchmark::Counter(state.iterations() * std::max<size_t>(fanOut + 1, 2), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Preprocessor)->Arg(0)->Arg(10)->Arg(100);
+
+static void BM_ToArabicConverter(benchmark::State& state) {
+    std::vector<std::u8string> romanNumbers;
+    for (int i = -3999; i < 4000; i++) {
+        romanNumbers.push_back(toRomanConverter(i));
+    }
+
+    for (auto _ : state) {
+        for (const auto& romanNumber : romanNumbers) {
+            int arabic = 0;
+            toArabicConverter(romanNumber, &arabic);
+            benchmark::DoNotOptimize(arabic);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * romanNumbers.size());
+}
+BENCHMARK(BM_ToArabicConverter);
+
+// as ErrorHandler formats line numbers
+static void BM_ToRomanConverter(benchmark::State& state) {
+    for (auto _ : state) {
+        for (int i = -3999; i < 4000; i++) {
+            RomanBuffer buffer;
+            benchmark::DoNotOptimize(toRomanConverter(i, buffer).data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * 7999);
+}
+BENCHMARK(BM_ToRomanConverter);
@@ -0,0 +1,73 @@
+#include "Corpora.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "IRGenerator.hpp"
+
+#include <map>
+#include <sstream>
+
+// Time (and memory, see MemoryCounter) of each stage against number of generated functions, 
+// complexity is fitted over source lines
+
+static const std::u8string& getScaledSource(size_t functionCount) {
+    static std::map<size_t, std::u8string> sources;
+    auto it = sources.find(functionCount);
+    if (it == sources.end()) {
+        it = sources.emplace(functionCount, generateSource(functionCount)).first;
+    }
+    return it->second;
+}
+
+static void setScale(benchmark::State& state, const std::u8string& sourceCode) {
+    state.SetComplexityN(std::count(sourceCode.begin(), sourceCode.end(), u8'\n'));
+    state.SetBytesProcessed(state.iterations() * sourceCode.size());
+}
+
+static void BM_ScalingLexer(benchmark::State& state) {
+    const std::u8string& sourceCode = getScaledSource(state.range(0));
+    std::ostringstream dump;
+
+    for (auto _ : state) {
+        std::vector<Token> tokens;
+        Lexer(sourceCode).tokenize(tokens, dump);
+        benchmark::DoNotOptimize(tokens.data());
+    }
+    setScale(state, sourceCode);
+}
+BENCHMARK(BM_ScalingLexer)->RangeMultiplier(4)->Range(16, 4096)->Complexity();
+
+static void BM_ScalingParser(benchmark::State& state) {
+    const std::u8string& sourceCode = getScaledSource(state.range(0));
+    std::ostringstream dump;
+    std::vector<Token> tokens;
+    Lexer(sourceCode).tokenize(tokens, dump);
+
+    for (auto _ : state) {
+        TokenStream stream = TokenStream(tokens);
+        Parser parser = Parser(stream);
+        std::unique_ptr<AST> tree = parser.parse();
+        benchmark::DoNotOptimize(tree.get());
+    }
+    setScale(state, sourceCode);
+}
+BENCHMARK(BM_ScalingParser)->RangeMultiplier(4)->Range(16, 4096)->Complexity();
+
+static void BM_ScalingIRGenerator(benchmark::State& state) {
+    const std::u8string& sourceCode = getScaledSource(state.range(0));
+    std::ostringstream dump;
+    std::vector<Token> tokens;
+    Lexer(sourceCode).tokenize(tokens, dump);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        TokenStream stream = TokenStream(tokens);
+        std::unique_ptr<AST> tree = Parser(stream).parse();
+        state.ResumeTiming();
+
+        IRGenerator codeGenerator = IRGenerator("scaling", tree);
+        codeGenerator.generateIRCode();
+        benchmark::DoNotOptimize(codeGenerator.getModule());
+    }
+    setScale(state, sourceCode);
+}
+BENCHMARK(BM_ScalingIRGenerator)->RangeMultiplier(4)->Range(16, 4096)->Complexity();
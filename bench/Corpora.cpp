@@ -0,0 +1,39 @@
+#include "Corpora.hpp"
+#include "Preprocessor.hpp"
+#include "generator/ProgramGenerator.hpp"
+
+static std::u8string preprocess(const std::filesystem::path& filePath) {
+    Preprocessor preprocessor = Preprocessor(filePath);
+    return preprocessor.getMergedSourceCode();
+}
+
+const std::vector<Corpus>& getCorpora() {
+    static const std::vector<Corpus> corpora = {
+        Corpus{ "std", preprocess(std::filesystem::path(LSC_SOURCE_DIR) / "examples" / "std.lorem") },
+        Corpus{ "binarytree", preprocess(std::filesystem::path(LSC_SOURCE_DIR) / "examples" / "binarytree.lorem") },
+        Corpus{ "generated-100", generateSource(100) },
+        Corpus{ "generated-1000", generateSource(1000) },
+    };
+    return corpora;
+}
+
+std::u8string generateSource(size_t functionCount) {
+    GeneratorOptions options;
+    options.functionCount = functionCount;
+    options.structCount = functionCount / 10;
+    return ProgramGenerator(options).generate();
+}
+
+std::filesystem::path writeIncludeTree(size_t fanOut) {
+    GeneratorOptions options;
+    options.functionCount = fanOut;
+    options.includeFanOut = fanOut;
+    options.structCount = 0;
+    return ProgramGenerator(options).writeFiles(std::filesystem::temp_directory_path() / ("lscBench-include-" + std::to_string(fanOut)));
+}
+
+void forEachCorpus(benchmark::internal::Benchmark* benchmark) {
+    for (size_t i = 0; i < CORPUS_COUNT; i++) {
+        benchmark->Arg(i);
+    }
+}
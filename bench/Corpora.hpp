@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#include "benchmark/benchmark.h"
+
+// Fixed source code every stage is measured on, so numbers are comparable between runs
+struct Corpus {
+    std::string name;
+    std::u8string sourceCode; // already preprocessed
+};
+
+// NOTE: Benchmarks are registered during static initialization, corpora aren't created that early
+//       (they run the Preprocessor and the program generator, that would slow down every startup), so their count is known upfront
+inline constexpr size_t CORPUS_COUNT = 4;
+
+/// @brief std.lorem, binarytree.lorem (merged with it's includes) and generated programs of 100 and 1000 functions
+const std::vector<Corpus>& getCorpora();
+
+/// @brief generated program with default knobs and given number of functions
+std::u8string generateSource(size_t functionCount);
+
+/// @brief writes generated program, that is spread over fanOut included files, into temporary directory
+/// @return path of main.lorem
+std::filesystem::path writeIncludeTree(size_t fanOut);
+
+/// @brief runs benchmark once for every corpus, index of corpus is first argument
+void forEachCorpus(benchmark::internal::Benchmark* benchmark);
@@ -0,0 +1,64 @@
+#include "MemoryCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Size of allocation is stored in front of it, so delete knows how much is freed
+static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    void* block = std::malloc(size + HEADER_SIZE);
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(block) = size;
+    MemoryCounter::onAllocate(size);
+    return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    void* block = static_cast<char*>(pointer) - HEADER_SIZE;
+    MemoryCounter::onDeallocate(*static_cast<size_t*>(block));
+    std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+void MemoryCounter::Start() {
+    s_allocationCount = 0;
+    s_totalBytes = 0;
+    s_currentBytes = 0;
+    s_peakBytes = 0;
+    s_recording = true;
+}
+
+void MemoryCounter::Stop(Result& result) {
+    s_recording = false;
+    result.num_allocs = s_allocationCount;
+    result.max_bytes_used = s_peakBytes;
+    result.total_allocated_bytes = s_totalBytes;
+    result.net_heap_growth = s_currentBytes;
+}
+
+void MemoryCounter::onAllocate(size_t size) {
+    if (!s_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_totalBytes.fetch_add(size, std::memory_order_relaxed);
+    int64_t current = s_currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    int64_t peak = s_peakBytes.load(std::memory_order_relaxed);
+    while (current > peak && !s_peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+}
+
+void MemoryCounter::onDeallocate(size_t size) {
+    if (!s_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    s_currentBytes.fetch_sub(size, std::memory_order_relaxed);
+}
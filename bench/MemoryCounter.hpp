@@ -0,0 +1,24 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+/// @brief Reports heap allocations of benchmarked code (allocs_per_iter, max_bytes_used in output),
+/// global operator new/delete of lscBench count every allocation
+class MemoryCounter : public benchmark::MemoryManager {
+public:
+    void Start() override;
+    void Stop(Result& result) override;
+
+    /// @brief called by operator new/delete
+    static void onAllocate(size_t size);
+    static void onDeallocate(size_t size);
+
+private:
+    inline static std::atomic<bool> s_recording = false;
+    inline static std::atomic<int64_t> s_allocationCount = 0;
+    inline static std::atomic<int64_t> s_totalBytes = 0;
+    inline static std::atomic<int64_t> s_currentBytes = 0;
+    inline static std::atomic<int64_t> s_peakBytes = 0;
+};
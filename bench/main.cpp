@@ -0,0 +1,14 @@
+#include "MemoryCounter.hpp"
+
+int main(int argc, char** argv) {
+    static MemoryCounter memoryCounter;
+    benchmark::RegisterMemoryManager(&memoryCounter);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
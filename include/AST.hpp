@@ -46,6 +46,7 @@ private:
 
 public:
     BlockAST(std::vector<std::unique_ptr<AST>> instructions, size_t line);
+    const std::vector<std::unique_ptr<AST>>& getInstructions() const;
     llvm::Value* codegen(IRContext& context) override;
     void printTree(std::ostream& ostr, const std::string& indent, bool isLast) const override; 
     size_t getLine() const override;
@@ -54,16 +55,18 @@ public:
 
 class NumberAST : public AST {
 private:
-    int m_value;
+    int64_t m_value;
     size_t m_line;
 
 public:
-    NumberAST(int value, size_t line);
+    NumberAST(int64_t value, size_t line);
     const IDataType* getType(const IRContext& context) override; 
     llvm::Value* codegen(IRContext& context) override;
     void printTree(std::ostream& ostr, const std::string& indent, bool isLast) const override; 
     size_t getLine() const override;
-    int getValue() const;
+    int64_t getValue() const;
+    /// @return true, if value doesn't fit into numerus and constant is magnus
+    bool isLong() const;
 };
 
 
@@ -120,6 +123,7 @@ public:
     VariableDeclarationAST(const std::u8string& name, std::unique_ptr<IDataType> type, size_t line);
     const std::u8string& getName() const override;
     const IDataType* getType(const IRContext& context) override; 
+    const IDataType* getDataType() const;
     llvm::Value* codegen(IRContext& context) override;
     void printTree(std::ostream& ostr, const std::string& indent, bool isLast) const override; 
     size_t getLine() const override;
@@ -189,6 +193,7 @@ public:
     const std::u8string& getName() const override;
     const IDataType* getType(const IRContext& context) override; 
     const std::vector<std::unique_ptr<TypeIdentifierPair>>& getArgs() const;
+    const IDataType* getReturnType() const;
     bool isDefined() const;
     llvm::Value* codegen(IRContext& context) override;
     void printTree(std::ostream& ostr, const std::string& indent, bool isLast) const override;
@@ -206,6 +211,7 @@ private:
 public:
     FunctionAST(std::unique_ptr<FunctionPrototypeAST> prototype, std::unique_ptr<BlockAST> body, size_t line);
     const std::u8string& getName() const override;
+    const FunctionPrototypeAST* getPrototype() const;
     const IDataType* getType(const IRContext& context) override; 
     llvm::Value* codegen(IRContext& context) override;
     void printTree(std::ostream& ostr, const std::string& indent, bool isLast) const override; 
@@ -291,6 +297,7 @@ public:
     StructAST(std::unique_ptr<StructDataType> attributes, size_t line);
     const std::u8string& getName() const override;
     const IDataType* getType(const IRContext& context) override; 
+    const StructDataType* getStructType() const;
     llvm::Value* codegen(IRContext& context) override;
     void printTree(std::ostream& ostr, const std::string& indent, bool isLast) const override; 
     size_t getLine() const override;
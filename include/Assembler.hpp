@@ -2,21 +2,45 @@
 #include <string>
 #include "llvm/IR/Module.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Passes/StandardInstrumentations.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/xxhash.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/raw_os_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
+#include "llvm/TargetParser/SubtargetFeature.h"
 #include "llvm/Linker/Linker.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Analysis/ModuleSummaryAnalysis.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Object/ObjectFile.h"
 #include "lld/Common/Driver.h"
 #include "lld/Common/ErrorHandler.h"
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <sstream>
 #include "fastlz.h"
+#include "Version.hpp"
+#include "ErrorHandler.hpp"
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 using namespace llvm;
 using namespace llvm::sys;
@@ -40,14 +64,120 @@ using namespace llvm::object;
     #include "lib/linux/libgcc.hpp"
 #endif
 
+enum class LTOMode {
+    None,
+    Full, // whole program is merged into one module at link time
+    Thin, // modules keep separate, only summaries are merged and functions imported across modules
+};
+
+struct CodeGenOptions {
+    OptimizationLevel optLevel = OptimizationLevel::O0;
+    std::string targetCpu = "generic"; // "native" means cpu and features of the host
+    Reloc::Model relocModel = Reloc::PIC_;
+    CodeModel::Model codeModel = CodeModel::Small;
+    bool inMemory = false; // hand object and runtime libraries to linker without temporary files
+    unsigned codegenThreads = 1; // module is split in this many partitions for instruction selection and emission
+    LTOMode lto = LTOMode::None; // emit bitcode instead of machine code, lld optimizes it together with bitcode libraries
+};
+
+using ObjectBuffer = SmallVector<char, 0>;
+
+/// @brief Anonymous file in RAM (memfd on linux), that can be opened by path while object is alive
+class MemoryFile {
+private:
+    int m_fileDescriptor;
+
+public:
+    MemoryFile(const char* name, const char* data, size_t size);
+    ~MemoryFile();
+    MemoryFile(const MemoryFile&) = delete;
+    MemoryFile& operator=(const MemoryFile&) = delete;
+
+    /// @return false, if platform doesn't support memory backed files or creation failed
+    bool isValid() const;
+    std::string getPath() const;
+};
+
 class Assembler {
 private:
+    inline static std::mutex s_linkerMutex; // lld has global state, so only one link can run at a time
+    inline static bool s_canLinkAgain = true; // lld couldn't clean up it's state after a failed link
+
     const std::string* m_irCode;
+    CodeGenOptions m_options;
 
 public:
-    void compileToObjectFile(const std::filesystem::path& objectFilePath, Module* module, CodeGenFileType fileType);
-    void compileToExecutable(const std::filesystem::path& objectFilePath, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries);
+    Assembler();
+    Assembler(const CodeGenOptions& options);
+
+    /// @return false, if object couldn't be emitted
+    bool compileToObjectFile(const std::filesystem::path& objectFilePath, Module* module, CodeGenFileType fileType);
+    /// @return false, if linking failed
+    bool compileToExecutable(const std::filesystem::path& objectFilePath, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries);
+
+    /// @brief like compileToObjectFile, but with codegenThreads > 1 module is split into several objects
+    /// @param outObjectFilePaths all written objects
+    /// @return false, if any object couldn't be emitted or written
+    bool compileToObjectFiles(const std::filesystem::path& objectFilePath, Module* module, std::vector<std::filesystem::path>* outObjectFilePaths);
+
+    /// @brief emits object (one per partition with codegenThreads > 1) into memory, nothing touches disk
+    /// @return false, if any partition couldn't be emitted
+    bool compileToObjectBuffers(std::vector<ObjectBuffer>* outBuffers, Module* module);
+
+    /// @brief links objects from memory, falls back to temporary files, if platform has no memory backed files
+    bool compileToExecutable(const std::vector<ObjectBuffer>& objectBuffers, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries);
+
+    /// @brief links objects of several modules (in given order), objects are kept
+    bool compileToExecutable(const std::vector<std::filesystem::path>& objectFilePaths, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries);
+
+    /// @return false, if lld's state is broken by earlier link, then no executable can be linked in this process anymore
+    static bool canLinkAgain();
+
+    /// @brief registers X86 target, it's enough to do it once per process
+    static void initializeTargets();
+
+    /// @brief runs new pass manager default pipeline (mem2reg, instcombine, GVN, inlining, ...) for optLevel
+    void optimizeModule(Module* module, TargetMachine* targetMachine);
+    static CodeGenOptLevel getCodeGenOptLevel(const OptimizationLevel& level);
+
+    /// @brief parses "-O0".."-O3" into optimization level
+    /// @return false, if argument is not a valid optimization flag
+    static bool parseOptimizationLevel(const std::string_view& arg, OptimizationLevel* outLevel);
+
+    /// @brief parses value of "--reloc=" option: pic, static
+    static bool parseRelocModel(const std::string_view& value, Reloc::Model* outModel);
+
+    /// @brief parses value of "--code-model=" option: small, kernel, medium, large
+    static bool parseCodeModel(const std::string_view& value, CodeModel::Model* outModel);
+
+    /// @brief parses value of "--lto=" option: full, thin
+    static bool parseLTOMode(const std::string_view& value, LTOMode* outMode);
 
 private:
+    std::unique_ptr<TargetMachine> createTargetMachine(Module* module) const;
+
+    /// @brief resolves "native" to host cpu name and features
+    void getTargetCpuAndFeatures(std::string* outCpu, std::string* outFeatures) const;
+
+    static bool emitFile(const std::filesystem::path& filePath, Module* module, TargetMachine* targetMachine, CodeGenFileType fileType);
+    static bool emit(raw_pwrite_stream& dest, Module* module, TargetMachine* targetMachine, CodeGenFileType fileType);
+
+    /// @brief writes module as bitcode for lto, with thin lto also module summary is written
+    void emitBitcode(raw_ostream& dest, Module* module) const;
+
+    /// @brief splits module into codegenThreads partitions and emits them in parallel
+    /// @return false, if any partition failed
+    bool emitPartitions(std::vector<ObjectBuffer>* outBuffers, Module* module) const;
+    /// @brief loads serialized partition into it's own context and emits it
+    bool emitPartition(StringRef bitcode, ObjectBuffer* outBuffer) const;
+
+    /// @return false, if lld failed
+    bool link(const std::vector<std::string>& objectFilePaths, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries);
+
+    /// @brief returns path of runtime library for linker: memory file in inMemory mode, cached file in temp directory otherwise
+    /// @return empty, if library couldn't be extracted
+    std::string extractRuntimeFile(const char* name, const unsigned char* compressedData, size_t compressedSize, size_t originalSize, std::vector<std::unique_ptr<MemoryFile>>* memoryFiles) const;
+    static std::vector<char> decompress(const unsigned char* compressedData, size_t compressedSize, size_t originalSize);
+    /// @return empty, if file couldn't be written
     static std::filesystem::path storeFileTmp(const char* name, const unsigned char* compressedData, size_t compressedSize, size_t originalSize);
 };
\ No newline at end of file
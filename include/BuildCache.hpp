@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "llvm/Support/BLAKE3.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Process.h"
+#include "Assembler.hpp"
+
+/// @brief Directory with executables of previous builds, keyed by everything that influences the output.
+/// Entries are evicted least recently used first, when the directory grows over size limit.
+class BuildCache {
+private:
+    std::filesystem::path m_cacheDir;
+    uint64_t m_maxSizeBytes;
+
+public:
+    BuildCache(const std::filesystem::path& cacheDir, uint64_t maxSizeBytes);
+
+    /// @brief hash of merged source code, link libraries (path, size, modification time), compiler build and codegen options
+    static std::string computeKey(const std::u8string& mergedSourceCode, const std::vector<std::filesystem::path>& linkLibraries, const CodeGenOptions& options);
+
+    /// @brief copies cached executable to executableFilePath
+    /// @return false, if there is no entry for key
+    bool fetch(const std::string& key, const std::filesystem::path& executableFilePath) const;
+
+    /// @brief adds executable to cache and evicts old entries
+    void store(const std::string& key, const std::filesystem::path& executableFilePath) const;
+
+private:
+    std::filesystem::path getEntryPath(const std::string& key) const;
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Driver.hpp"
+
+#if !defined(_WIN32)
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <sys/stat.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    #include <signal.h>
+#endif
+
+/// @brief Resident compiler process: LLVM targets stay initialized and included files stay cached between compilations.
+/// Client sends it's working directory, arguments, stdout and stderr over unix socket, 
+/// server compiles with them (requests are handled one after another) and answers with exit code.
+/// Programs requested with --run are compiled and run in a child process.
+class CompileServer {
+private:
+    static constexpr uint32_t MAX_PAYLOAD_SIZE = 4 * 1024 * 1024; // working directory and arguments of one request
+
+public:
+    /// @brief listens on socket until process is killed
+    /// @return 1, if socket couldn't be created
+    static int serve(const std::string& socketPath);
+
+    /// @brief thin client: forwards arguments (without program name) to server
+    /// @return exit code of compilation, or 1 if server isn't reachable
+    static int connect(const std::string& socketPath, const std::vector<std::string>& args);
+
+private:
+    static void handleClient(int clientSocket);
+    /// @return exit code of program, 128 + signal number if it was killed
+    static int runInChildProcess(const CompilerOptions& options);
+    static bool writeAll(int fileDescriptor, const char* data, size_t size);
+    static bool readAll(int fileDescriptor, char* data, size_t size);
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <iostream>
+#include <cerrno>
+#include <climits>
+#include "Preprocessor.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "IRGenerator.hpp"
+#include "Assembler.hpp"
+#include "JITRunner.hpp"
+#include "BuildCache.hpp"
+#include "ModuleCompiler.hpp"
+#include "ErrorHandler.hpp"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/ThreadPool.h"
+
+/// @brief everything that can be set from command line
+struct CompilerOptions {
+    std::vector<std::string> inputFilePaths;
+    unsigned jobs = 1; // how many input files (or modules) are compiled in parallel
+    bool modules = false; // every included .lorem file is compiled to it's own object
+    CodeGenOptions codeGenOptions;
+    std::string timeTraceFile; // empty means no time trace
+    unsigned timeTraceGranularity = 500;
+    bool runInJit = false;
+    std::vector<std::string> runArgs; // arguments of the program in JIT mode
+    std::string serverSocket; // empty means no server mode
+    std::string cacheDir; // empty means no build cache
+    uint64_t cacheSizeBytes = 1024ull * 1024 * 1024;
+    bool writeDepFile = false; // Makefile rule with included files next to executable (or in depFile)
+    std::string depFile; // empty means <executable>.d
+    bool printDeps = false; // only resolve includes and print Makefile rule, nothing is compiled
+    bool emitModule = false; // input files are compiled to precompiled modules (.lmod) instead of executables
+};
+
+/// @brief Parses command line and runs compiler phases, shared by command line and compile server
+class Driver {
+public:
+    static void printHelp(std::ostream& ostr);
+
+    /// @brief argv[0] is program name
+    /// @return false, if arguments are invalid (reason is printed to std::cerr)
+    static bool parseArguments(int argc, const char** argv, CompilerOptions* outOptions);
+
+    /// @brief compiles input file to executable (or runs it in JIT), writes time trace if requested
+    /// @return exit code of compiler, or of the program in JIT mode
+    static int run(const CompilerOptions& options);
+
+private:
+    /// @brief parses whole value as decimal number, that fits into unsigned
+    /// @return false, if value is empty, has other characters than digits or is too big
+    static bool parseUnsigned(const char* value, unsigned* outValue);
+
+    static int compile(const std::filesystem::path& mainFilePath, const CompilerOptions& options);
+    static std::filesystem::path getExecutablePath(const std::filesystem::path& mainFilePath);
+
+    /// @brief resolves includes of file and prints them as Makefile rule to std::cout, nothing is compiled
+    static int printDependencies(const std::filesystem::path& mainFilePath);
+    static bool writeDepFile(const Preprocessor& preprocessor, const std::filesystem::path& exeFilePath, const CompilerOptions& options);
+    static int compileModules(const Preprocessor& preprocessor, const std::filesystem::path& mainFilePath, const std::filesystem::path& exeFilePath, const CompilerOptions& options);
+
+    /// @brief compiles every file on thread pool, errors of each file are printed together in order of input files
+    /// @return first non zero exit code
+    static int compileBatch(const std::vector<std::filesystem::path>& mainFilePaths, const CompilerOptions& options);
+};
@@ -8,27 +8,41 @@
 #include <sstream>
 #include "RomanNumber.hpp"
 #include <mutex>
+#include <optional>
 #include <assert.h>
-#include "SourceLine.hpp"
+#include "SourceManager.hpp"
 
 class ErrorHandler {
 private:
-    const std::vector<SourceLine>* m_sourceLines; // Reference to source lines for error reporting
+    const SourceManager* m_sources; // Reference to source files and merged lines for error reporting
     bool m_errorFlag;
     bool m_warnFlag;
+    std::ostream* m_output; // where errors and warnings are printed
+    std::ostream* m_logOutput; // where debug dumps and other messages for stdout are printed
 
-    inline static ErrorHandler* s_instance = nullptr; // Singleton instance
-    inline static std::mutex s_mutex; // Mutex for thread safety
-    ErrorHandler() : m_sourceLines(nullptr), m_errorFlag(false), m_warnFlag(false) {} // Private constructor for singleton pattern
+    ErrorHandler() : m_sources(nullptr), m_errorFlag(false), m_warnFlag(false), m_output(&std::cerr), m_logOutput(&std::cout) {} // Private constructor for singleton pattern
 
 public:
     // Deleting copy constructor and assignment operator to prevent copying
     ErrorHandler(const ErrorHandler& obj) = delete;
 
-    /// @brief Static method to get the singleton instance of ErrorHandler
+    /// @brief Static method to get the instance of ErrorHandler, 
+    /// every thread has it's own, so files can be compiled in parallel
     static ErrorHandler* getInstance();
 
-    static void init(const std::vector<SourceLine>& lines);
+    static void init(const SourceManager& sources);
+
+    /// @brief forgets source lines and logged errors/warnings, so next compilation starts clean
+    static void reset();
+
+    /// @brief redirects messages of this thread (std::cerr by default), 
+    /// so output of parallel compilations can be printed grouped by file
+    static void setOutput(std::ostream* ostr);
+    static std::ostream& getOutput();
+
+    /// @brief redirects debug dumps (source, tokens, tree, IR) and other stdout messages of this thread (std::cout by default)
+    static void setLogOutput(std::ostream* ostr);
+    static std::ostream& getLogOutput();
 
     /// @return returns bool based on if any errors happened before hand
     static bool hasError();
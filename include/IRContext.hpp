@@ -20,6 +20,7 @@ struct ScopeEntry {
     const std::u8string* name;
     const IDataType* type;
     llvm::Value* value;
+    std::vector<const IDataType*> argTypes; // only for functions
 
     ScopeEntry(const std::u8string* name, const IDataType* type, llvm::Value* value);
 };
@@ -43,7 +44,7 @@ public:
     void clearScopes();
     void addVariable(const std::u8string& name, const IDataType* type, llvm::Value* value);
     void addGlobal(const std::u8string& name, const IDataType* type, llvm::GlobalVariable* value);
-    void addFunction(const std::u8string& name, const IDataType* type, llvm::Value* value);
+    void addFunction(const std::u8string& name, const IDataType* type, llvm::Value* value, const std::vector<const IDataType*>& argTypes);
     void addStruct(const std::u8string& name, const StructDataType* type);
     const ScopeEntry* lookupVariable(const std::u8string& name) const;
     const ScopeEntry* lookupFunction(const std::u8string& name) const;
@@ -56,4 +57,5 @@ struct IRContext {
     std::unique_ptr<llvm::IRBuilder<>> builder;
     SymbolTable symbolTable;
     std::stack<llvm::BasicBlock*> afterLoop; // needed for break in a nestes for loop
+    bool declarationsOnly = false; // generates interface of other module: functions and globals are declared, not defined
 };
\ No newline at end of file
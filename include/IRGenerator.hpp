@@ -1,5 +1,10 @@
 #pragma once
 #include "AST.hpp"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/Transforms/Utils/ModuleUtils.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/TimeProfiler.h"
 
 /// @brief Transforms Abstract syntax tree in Intermediate Representation of LLVM
 class IRGenerator {
@@ -11,6 +16,19 @@ public:
     IRGenerator(const char* moduleID, const std::unique_ptr<AST>& rootBlock);
 
     void generateIRCode();
+
+    /// @brief declares functions, globals and structs of imported module, so this module can use them
+    void generateInterface(AST* importedRoot);
+
+    /// @brief generates module, that isn't program entry: 
+    /// it's wrapper function (initFunctionName) is called as global constructor before main
+    void generateModuleIRCode(const char* initFunctionName);
+
+    /// @brief links bitcode of precompiled module into this module, it's definitions resolve declarations of it's interface
+    void linkModule(llvm::MemoryBufferRef bitcode);
     llvm::Module* getModule();
+
+    /// @brief moves module together with it's context out of generator (for JIT), getModule() returns nullptr afterwards
+    llvm::orc::ThreadSafeModule takeModule();
     std::string getIRCodeString();
 };
@@ -0,0 +1,23 @@
+#pragma once
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/ExecutionEngine/Orc/TargetProcess/TargetExecutionUtils.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "Assembler.hpp"
+
+/// @brief Compiles module in memory with ORC LLJIT and calls it's main, without object file or executable
+class JITRunner {
+private:
+    CodeGenOptions m_options;
+
+public:
+    JITRunner(const CodeGenOptions& options);
+
+    /// @brief externs (printf, ...) are resolved from this process, link libraries (.a, .so, .o) are loaded into JIT
+    /// @return exit code of main, or 1 if module couldn't be compiled
+    int run(llvm::orc::ThreadSafeModule module, const std::vector<std::filesystem::path>& linkLibraries, const std::string& programName, const std::vector<std::string>& programArgs);
+
+private:
+    Error addLinkLibrary(llvm::orc::LLJIT* jit, const std::filesystem::path& libraryPath);
+};
@@ -3,30 +3,40 @@
 #include <codecvt>
 #include <cstring>
 #include <iostream>
+#include <unordered_map>
 #include <vector>
 #include "Token.hpp"
 #include "Syntax.hpp"
+#include "LexerTrie.hpp"
+#include "LexerScan.hpp"
+#include "RomanNumber.hpp"
 #include "ErrorHandler.hpp"
 
 class Lexer {
    private:
     const std::u8string* m_souceCode;
-    int m_charIterator;
+    size_t m_charIterator; // 64-bit, so sources over 2 GB can be lexed
     size_t m_lineCounter;
+    std::unordered_map<std::u8string_view, uint32_t> m_identifierIds;
 
    public:
     Lexer(const std::u8string& sourceCode);
+    /// @brief lexes whole source at once, TokenStream pulls tokens one by one instead
     void tokenize(std::vector<Token>& outTokens, std::ostream &ostr);
-    
-private:
-    /// @return next token from code given in constructor
+
+    /// @return next token from code given in constructor, EOF_TOKEN at the end
     Token getNextToken();
 
-    /// @brief checks if text starts with some string from vector
-    /// @param allowIdentifierAfter if true, will allow identifiers to start directly after operators without space in-between.
-    ///                     Example: operators can be before identifier "¬cadabra"
-    /// @return index to the string, or -1 if current code is not starting with any element from the vector
-    int startWithWord(const std::u8string_view* words, size_t wordsSize, bool allowIdentifierAfter) const;
+    /// @brief prints token for debug output of tokens
+    static void printToken(std::ostream &ostr, const Token& token);
+
+private:
+    char8_t getCharAt(size_t index) const;
+
+    /// @return index of first byte from index on, which belongs to set, size of source code if there is none
+    size_t findFirstOf(size_t index, const lexer_scan::ByteSet& set) const;
+    size_t findFirstNotOf(size_t index, const lexer_scan::ByteSet& set) const;
 
-    char8_t getCharAt(int index) const;
+    /// @return view of source code in [start, end)
+    std::u8string_view getSourceView(size_t start, size_t end) const;
 };
\ No newline at end of file
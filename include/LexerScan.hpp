@@ -0,0 +1,129 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include "LexerTrie.hpp"
+
+// Kernels, which find next interesting byte of source code 16 or 32 bytes at a time (SSSE3, AVX2),
+// so lexer can slice whitespace, comments, strings and identifiers in one step.
+// Best kernel supported by CPU is chosen at runtime, other CPUs use scalar fallback.
+namespace lexer_scan {
+    enum class SimdLevel {
+        SCALAR,
+        SSSE3,  // 16 bytes at a time
+        AVX2,   // 32 bytes at a time
+    };
+
+    // Set of bytes in form used by SIMD kernels: byte belongs to set,
+    // if table entries of it's low and high nibble share a bit (bit is a bucket of high nibbles with same low nibbles).
+    struct ByteSet {
+        std::array<bool, 256> contains;
+        std::array<uint8_t, 16> lowNibbles;
+        std::array<uint8_t, 16> highNibbles;
+    };
+
+    consteval ByteSet makeByteSet(const std::array<bool, 256>& contains) {
+        ByteSet set{};
+        set.contains = contains;
+
+        std::array<uint16_t, 8> bucketLowNibbles{}; // low nibbles of each bucket
+        size_t bucketCount = 0;
+        for (size_t high = 0; high < 16; high++) {
+            uint16_t lowNibbles = 0;
+            for (size_t low = 0; low < 16; low++) {
+                if (contains[high << 4 | low]) {
+                    lowNibbles |= 1 << low;
+                }
+            }
+            if (lowNibbles == 0) {
+                continue;
+            }
+
+            size_t bucket = 0;
+            while (bucket < bucketCount && bucketLowNibbles[bucket] != lowNibbles) {
+                bucket++;
+            }
+            if (bucket == bucketCount) {
+                if (bucketCount == bucketLowNibbles.size()) {
+                    throw "Byte set needs more than 8 buckets"; // fails compilation
+                }
+                bucketLowNibbles[bucketCount++] = lowNibbles;
+            }
+
+            set.highNibbles[high] = 1 << bucket;
+            for (size_t low = 0; low < 16; low++) {
+                if (lowNibbles & (1 << low)) {
+                    set.lowNibbles[low] |= 1 << bucket;
+                }
+            }
+        }
+        return set;
+    }
+
+    consteval ByteSet makeByteSet(std::initializer_list<char8_t> bytes, const std::array<bool, 256>& otherBytes = {}) {
+        std::array<bool, 256> contains = otherBytes;
+        for (char8_t byte : bytes) {
+            contains[byte] = true;
+        }
+        return makeByteSet(contains);
+    }
+
+    /// @return true, if nibble tables describe the same bytes as contains
+    consteval bool isConsistent(const ByteSet& set) {
+        for (size_t byte = 0; byte < 256; byte++) {
+            bool inTables = (set.lowNibbles[byte & 0x0F] & set.highNibbles[byte >> 4]) != 0;
+            if (inTables != set.contains[byte]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline constexpr ByteSet BLANKS = makeByteSet({u8' ', u8'\t', u8'\r'});
+    inline constexpr ByteSet LINE_ENDS = makeByteSet({u8'\n', u8'\0'});
+    inline constexpr ByteSet LITERAL_ENDS = makeByteSet({punctuation::APOSTROPHE[0], u8'\0'});
+    inline constexpr ByteSet STRING_ENDS = makeByteSet({punctuation::QUOTE[0], u8'\0'});
+    // bytes, at which identifier may end, lead bytes of multi-byte operators included (check with startsWithSymbol)
+    inline constexpr ByteSet IDENTIFIER_ENDS = makeByteSet({u8' ', u8'\n', u8'\r', u8'\0'}, lexer_trie::SYMBOL_STARTS);
+
+    static_assert(isConsistent(BLANKS) && isConsistent(LINE_ENDS) && isConsistent(LITERAL_ENDS));
+    static_assert(isConsistent(STRING_ENDS) && isConsistent(IDENTIFIER_ENDS));
+
+    /// @return best level supported by CPU, detected once
+    SimdLevel getSimdLevel();
+
+    /// @return first byte in [begin, end) which belongs to set, end if there is none
+    const char8_t* findFirstOf(const char8_t* begin, const char8_t* end, const ByteSet& set, SimdLevel level);
+
+    /// @return first byte in [begin, end) which doesn't belong to set, end if there is none
+    const char8_t* findFirstNotOf(const char8_t* begin, const char8_t* end, const ByteSet& set, SimdLevel level);
+
+    // kernels of best level supported by CPU
+    const char8_t* findFirstOfWide(const char8_t* begin, const char8_t* end, const ByteSet& set);
+    const char8_t* findFirstNotOfWide(const char8_t* begin, const char8_t* end, const ByteSet& set);
+
+    // NOTE: most runs in source code are short (single space, short names), 
+    //       call of kernel costs more than looking at few bytes, so they are checked inline first
+    inline constexpr size_t SHORT_RUN = 8;
+
+    /// @return first byte in [begin, end) which belongs to set, end if there is none
+    inline const char8_t* findFirstOf(const char8_t* begin, const char8_t* end, const ByteSet& set) {
+        for (const char8_t* shortRunEnd = static_cast<size_t>(end - begin) > SHORT_RUN ? begin + SHORT_RUN : end; begin != shortRunEnd; begin++) {
+            if (set.contains[*begin]) {
+                return begin;
+            }
+        }
+        return begin == end ? end : findFirstOfWide(begin, end, set);
+    }
+
+    /// @return first byte in [begin, end) which doesn't belong to set, end if there is none
+    inline const char8_t* findFirstNotOf(const char8_t* begin, const char8_t* end, const ByteSet& set) {
+        for (const char8_t* shortRunEnd = static_cast<size_t>(end - begin) > SHORT_RUN ? begin + SHORT_RUN : end; begin != shortRunEnd; begin++) {
+            if (!set.contains[*begin]) {
+                return begin;
+            }
+        }
+        return begin == end ? end : findFirstNotOfWide(begin, end, set);
+    }
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include "Syntax.hpp"
+#include "Token.hpp"
+
+// Trie over bytes of every fixed word in Syntax.hpp (punctuation, operators, booleans, keywords, types),
+// generated at compile time. Lexer classifies a word with one walk over it's bytes,
+// multi-byte UTF-8 operators (⇔, ≠, λ, ...) are just longer paths.
+namespace lexer_trie {
+    struct Word {
+        std::u8string_view text;
+        TokenType type;
+        TokenKind kind;
+    };
+
+    inline constexpr Word WORDS[] = {
+        {punctuation::PAREN_OPEN, TokenType::PUNCTUATION, TokenKind::PAREN_OPEN},
+        {punctuation::PAREN_CLOSE, TokenType::PUNCTUATION, TokenKind::PAREN_CLOSE},
+        {punctuation::BLOCK_OPEN, TokenType::PUNCTUATION, TokenKind::BLOCK_OPEN},
+        {punctuation::BLOCK_CLOSE, TokenType::PUNCTUATION, TokenKind::BLOCK_CLOSE},
+        {punctuation::COMMA, TokenType::PUNCTUATION, TokenKind::COMMA},
+        {punctuation::SQR_BRACKET_OPEN, TokenType::PUNCTUATION, TokenKind::SQR_BRACKET_OPEN},
+        {punctuation::SQR_BRACKET_CLOSE, TokenType::PUNCTUATION, TokenKind::SQR_BRACKET_CLOSE},
+        {punctuation::APOSTROPHE, TokenType::PUNCTUATION, TokenKind::APOSTROPHE},
+        {punctuation::QUOTE, TokenType::PUNCTUATION, TokenKind::QUOTE},
+
+        {boolean_types::TRUE, TokenType::BOOL, TokenKind::TRUE},
+        {boolean_types::FALSE, TokenType::BOOL, TokenKind::FALSE},
+
+        {keywords::FUNCTION, TokenType::KEYWORD, TokenKind::FUNCTION},
+        {keywords::RETURN, TokenType::KEYWORD, TokenKind::RETURN},
+        {keywords::BREAK, TokenType::KEYWORD, TokenKind::BREAK},
+        {keywords::FOR_LOOP, TokenType::KEYWORD, TokenKind::FOR_LOOP},
+        {keywords::IF, TokenType::KEYWORD, TokenKind::IF},
+        {keywords::ELIF, TokenType::KEYWORD, TokenKind::ELIF},
+        {keywords::ELSE, TokenType::KEYWORD, TokenKind::ELSE},
+        {keywords::INCLUDE, TokenType::KEYWORD, TokenKind::INCLUDE},
+
+        {types::INT, TokenType::TYPE, TokenKind::INT},
+        {types::LONG, TokenType::TYPE, TokenKind::LONG},
+        {types::BOOL, TokenType::TYPE, TokenKind::BOOL},
+        {types::CHAR, TokenType::TYPE, TokenKind::CHAR},
+        {types::VOID, TokenType::TYPE, TokenKind::VOID},
+        {types::STRUCT, TokenType::TYPE, TokenKind::STRUCT},
+
+        {operators::ASSIGN, TokenType::OPERATOR, TokenKind::ASSIGN},
+        {operators::EQUAL, TokenType::OPERATOR, TokenKind::EQUAL},
+        {operators::NOT_EQUAL, TokenType::OPERATOR, TokenKind::NOT_EQUAL},
+        {operators::GREATER, TokenType::OPERATOR, TokenKind::GREATER},
+        {operators::LESSER, TokenType::OPERATOR, TokenKind::LESSER},
+        {operators::GREATER_OR_EQUAL, TokenType::OPERATOR, TokenKind::GREATER_OR_EQUAL},
+        {operators::LESSER_OR_EQUAL, TokenType::OPERATOR, TokenKind::LESSER_OR_EQUAL},
+        {operators::PLUS, TokenType::OPERATOR, TokenKind::PLUS},
+        {operators::MINUS, TokenType::OPERATOR, TokenKind::MINUS},
+        {operators::MULTIPLY, TokenType::OPERATOR, TokenKind::MULTIPLY},
+        {operators::DIVIDE, TokenType::OPERATOR, TokenKind::DIVIDE},
+        {operators::MODULO, TokenType::OPERATOR, TokenKind::MODULO},
+        {operators::POWER, TokenType::OPERATOR, TokenKind::POWER},
+        {operators::NOT, TokenType::OPERATOR, TokenKind::NOT},
+        {operators::FACTORIAL, TokenType::OPERATOR, TokenKind::FACTORIAL},
+        {operators::AND, TokenType::OPERATOR, TokenKind::AND},
+        {operators::OR, TokenType::OPERATOR, TokenKind::OR},
+    };
+    inline constexpr size_t WORDS_SIZE = std::size(WORDS);
+
+    consteval bool isOrderedByKind() {
+        for (size_t i = 0; i < WORDS_SIZE; i++) {
+            if (static_cast<size_t>(WORDS[i].kind) != i + 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(isOrderedByKind(), "WORDS have to be in order of TokenKind, so getWord() can index them");
+
+    /// @return fixed word of the kind, kind must not be TokenKind::NONE
+    constexpr const Word& getWord(TokenKind kind) {
+        return WORDS[static_cast<size_t>(kind) - 1];
+    }
+
+    /// @brief punctuation and operators end identifiers, words made of letters don't
+    constexpr bool isSymbol(TokenType type) {
+        return type == TokenType::PUNCTUATION || type == TokenType::OPERATOR;
+    }
+
+    // Only bytes, that occur in some word, get a column in transition table, 0 means no word has this byte
+    consteval std::array<uint8_t, 256> makeByteClasses() {
+        std::array<uint8_t, 256> byteClasses{};
+        uint8_t classCount = 1;
+        for (const Word& word : WORDS) {
+            for (char8_t character : word.text) {
+                if (byteClasses[character] == 0) {
+                    byteClasses[character] = classCount++;
+                }
+            }
+        }
+        return byteClasses;
+    }
+    inline constexpr std::array<uint8_t, 256> BYTE_CLASSES = makeByteClasses();
+
+    consteval size_t countByteClasses() {
+        size_t classCount = 0;
+        for (uint8_t byteClass : BYTE_CLASSES) {
+            classCount = std::max<size_t>(classCount, byteClass + 1);
+        }
+        return classCount;
+    }
+    inline constexpr size_t CLASS_COUNT = countByteClasses();
+
+    consteval size_t countMaxNodes() {
+        size_t nodeCount = 1; // root
+        for (const Word& word : WORDS) {
+            nodeCount += word.text.length();
+        }
+        return nodeCount;
+    }
+    inline constexpr size_t MAX_NODES = countMaxNodes();
+    static_assert(MAX_NODES <= 256, "Node indices of trie have to fit into uint8_t");
+
+    // Bytes, at which punctuation or operator can begin
+    consteval std::array<bool, 256> makeSymbolStarts() {
+        std::array<bool, 256> symbolStarts{};
+        for (const Word& word : WORDS) {
+            if (isSymbol(word.type)) {
+                symbolStarts[word.text[0]] = true;
+            }
+        }
+        return symbolStarts;
+    }
+    inline constexpr std::array<bool, 256> SYMBOL_STARTS = makeSymbolStarts();
+
+    struct Trie {
+        std::array<std::array<uint8_t, CLASS_COUNT>, MAX_NODES> next; // 0 means no transition, root is never a target
+        std::array<int8_t, MAX_NODES> word;                           // index into WORDS, -1 if no word ends in node
+    };
+
+    consteval Trie makeTrie() {
+        Trie trie{};
+        trie.word.fill(-1);
+        uint8_t nodeCount = 1;
+        for (size_t i = 0; i < WORDS_SIZE; i++) {
+            uint8_t node = 0;
+            for (char8_t character : WORDS[i].text) {
+                uint8_t& next = trie.next[node][BYTE_CLASSES[character]];
+                if (next == 0) {
+                    next = nodeCount++;
+                }
+                node = next;
+            }
+            trie.word[node] = static_cast<int8_t>(i);
+        }
+        return trie;
+    }
+    inline constexpr Trie TRIE = makeTrie();
+
+    struct Match {
+        int wordIndex = -1; // index into WORDS, -1 if text doesn't start with a word
+        size_t length = 0;
+    };
+
+    /// @brief finds longest word at the beginning of null terminated text
+    constexpr Match matchLongest(const char8_t* text) {
+        Match match;
+        uint8_t node = 0;
+        for (size_t i = 0; BYTE_CLASSES[text[i]] != 0; i++) {
+            node = TRIE.next[node][BYTE_CLASSES[text[i]]];
+            if (node == 0) {
+                break;
+            }
+            if (TRIE.word[node] != -1) {
+                match = Match{ TRIE.word[node], i + 1 };
+            }
+        }
+        return match;
+    }
+
+    /// @return true, if punctuation or operator begins at the start of null terminated text
+    constexpr bool startsWithSymbol(const char8_t* text) {
+        if (!SYMBOL_STARTS[text[0]]) {
+            return false;
+        }
+        Match match = matchLongest(text);
+        return match.wordIndex != -1 && isSymbol(WORDS[match.wordIndex].type);
+    }
+
+    static_assert(WORDS[matchLongest(u8"nisi:").wordIndex].text == keywords::ELIF);
+    static_assert(WORDS[matchLongest(u8"nihil x").wordIndex].text == types::VOID);
+    static_assert(WORDS[matchLongest(u8"⇔ b").wordIndex].text == operators::EQUAL);
+    static_assert(matchLongest(u8"⇔ b").length == operators::EQUAL.length());
+    static_assert(matchLongest(u8"abra").wordIndex == -1);
+    static_assert(WORDS[matchLongest(u8"∨").wordIndex].kind == TokenKind::OR);
+    static_assert(startsWithSymbol(u8"≠") && !startsWithSymbol(u8"∑") && !startsWithSymbol(u8"si"));
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <sstream>
+#include <optional>
+#include "Preprocessor.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "IRGenerator.hpp"
+#include "Assembler.hpp"
+#include "BuildCache.hpp"
+#include "llvm/Support/ThreadPool.h"
+
+// Every .lorem file is a compilation unit with it's own object file
+struct ModuleUnit {
+    const LoremSourceFile* file;
+    std::string name; // unique between units, used for object and initializer names
+    SourceManager sources; // only this file, without included files
+    std::string sourceKey; // covers only this unit
+    std::string cacheKey; // covers this unit and interface of units before it
+    std::filesystem::path objectFilePath;
+    bool isUpToDate;
+
+    std::unique_ptr<AST> tree;
+    std::ostringstream diagnostics;
+    std::ostringstream log; // debug dumps
+};
+
+/// @brief Compiles apere-included files separately: each unit sees declarations of units before it 
+/// (same as in merged source), top level code of included unit runs as global constructor before main.
+/// Objects are kept in objectDir and only units with changed key are compiled again: 
+/// unit changed itself or declarations (structs, globals, prototypes) of unit before it changed.
+class ModuleCompiler {
+private:
+    CodeGenOptions m_options;
+    unsigned m_jobs;
+    unsigned m_timeTraceGranularity;
+    std::filesystem::path m_objectDir;
+    std::vector<std::unique_ptr<ModuleUnit>> m_units; // main file is last
+
+public:
+    ModuleCompiler(const Preprocessor& preprocessor, const CodeGenOptions& options, unsigned jobs, unsigned timeTraceGranularity, const std::filesystem::path& objectDir);
+
+    /// @brief objects are in link order: included units before units that include them
+    /// @return false, if any unit has errors (they are printed grouped by unit)
+    bool compile(std::vector<std::filesystem::path>* outObjectFiles);
+
+    /// @brief name of file's module, used for object and initializer names
+    static std::string getModuleName(const std::filesystem::path& filePath);
+
+    /// @brief function with top level code of module, it's called as global constructor before main
+    static std::string getInitFunctionName(const std::string& moduleName);
+
+    /// @brief compiles library to precompiled module next to it (lsc --emit-module), 
+    /// it's top level code is run by init function, same as code of included unit
+    /// @return false, if library has errors or module couldn't be written
+    static bool emitPrecompiledModule(const Preprocessor& preprocessor, const std::filesystem::path& mainFilePath);
+
+private:
+    bool parseUnit(ModuleUnit* unit, const std::vector<std::u8string>& knownStructs, bool isMain, std::vector<std::u8string>* outStructs);
+    bool compileUnit(size_t index);
+};
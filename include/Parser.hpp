@@ -2,12 +2,21 @@
 #include <format>
 #include "AST.hpp"
 #include "Token.hpp"
+#include "TokenStream.hpp"
 #include "RomanNumber.hpp"
 
+// lets m_structHashMap be searched with views of tokens without copying them into strings
+struct StructNameHash {
+    using is_transparent = void;
+    size_t operator()(std::u8string_view name) const {
+        return std::hash<std::u8string_view>{}(name);
+    }
+};
+
 class Parser {
 private:
-    const std::vector<Token>& m_tokens;
-    std::vector<Token>::const_iterator m_currentToken;
+    TokenStream& m_tokens;
+    const Token* m_currentToken; // points into lookahead buffer of m_tokens, copy tokens needed after getNextToken()
     std::ostream &m_ostr;
     
     int m_loopCount;
@@ -15,15 +24,24 @@ private:
     bool m_isValid;
     bool m_isTest;
     std::vector<std::unique_ptr<AST>> m_topLevelDeclarations;
-    std::unordered_map<std::u8string, StructDataType*> m_structHashMap;
+    std::unordered_map<std::u8string, StructDataType*, StructNameHash, std::equal_to<>> m_structHashMap; // nullptr for structs of other modules
+    std::u8string m_entryFunctionName;
 
 public:
-    Parser(const std::vector<Token>& tokens);
-    Parser(const std::vector<Token>& tokens, bool isTest, std::ostream &m_ostr);
+    Parser(TokenStream& tokens);
+    Parser(TokenStream& tokens, bool isTest, std::ostream &m_ostr);
 
     bool isValid();
     std::unique_ptr<BlockAST> parse();
 
+    /// @brief top level instructions are wrapped in this function ("main" by default),
+    /// any other name makes function without return value, which initializes module
+    void setEntryFunctionName(const std::u8string& name);
+
+    /// @brief makes struct type declared in other module known to parser
+    void addStructName(const std::u8string& name);
+    std::vector<std::u8string> getStructNames() const;
+
     //for ErrorHandler
     size_t currentLine = 1;
     std::vector<size_t> lastOpenBlock;
@@ -36,9 +54,9 @@ private:
     bool isFinishedBlock();
     bool isExpressionEnd();
     bool isToken(TokenType type);
-    bool isToken(TokenType type, const std::u8string_view& value);
-    bool isToken(const std::u8string_view& value);
+    bool isToken(TokenKind kind);
     bool isUnaryOperator();
+    bool isStructName();
     std::unique_ptr<IDataType> parseType();
 
 
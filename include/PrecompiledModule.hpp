@@ -0,0 +1,66 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "AST.hpp"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+/// @brief Library compiled ahead of time (lsc --emit-module lib.lorem) to lib.lmod next to it:
+/// interface of its top level declarations (function prototypes, globals, struct layouts) and bitcode of its definitions.
+/// Files that include lib.lorem declare the interface and link the bitcode, lib isn't lexed, parsed and generated again.
+/// Top level code of the library runs as global constructor before main (same as with --modules).
+class PrecompiledModule {
+private:
+    std::filesystem::path m_filePath;
+    std::unique_ptr<llvm::MemoryBuffer> m_buffer;
+    std::vector<std::pair<std::filesystem::path, uint64_t>> m_sourceFiles; // every .lorem file of module and hash of its content
+    std::vector<std::filesystem::path> m_linkLibraries;
+    std::unique_ptr<BlockAST> m_interface; // declarations only
+    std::vector<std::u8string> m_structNames;
+    llvm::StringRef m_bitcode; // view of buffer
+
+    PrecompiledModule();
+
+public:
+    static constexpr const char* FILE_EXTENSION = ".lmod";
+
+    /// @return path of module, that is built from source file
+    static std::filesystem::path getModulePath(const std::filesystem::path& sourceFilePath);
+
+    /// @brief hash of source file, module is stale when it doesn't match anymore
+    static uint64_t hashSourceFile(llvm::StringRef sourceCode);
+
+    /// @brief top level declarations of root (except initFunctionName) in the format of module file,
+    /// units compiled with --modules are keyed by interface of units before them
+    static std::string serializeInterface(const BlockAST* root, const std::string& initFunctionName);
+
+    /// @return nullptr, if there is no module or it's not readable (damaged or written by other compiler build)
+    static std::unique_ptr<PrecompiledModule> load(const std::filesystem::path& filePath);
+
+    /// @brief writes interface of root's top level declarations (except initFunctionName) and bitcode of module
+    /// @param sourceFiles every .lorem file the module is made of, with its content
+    /// @return false, if file couldn't be written
+    static bool write(
+        const std::filesystem::path& filePath,
+        const std::vector<std::pair<std::filesystem::path, std::u8string_view>>& sourceFiles,
+        const std::vector<std::filesystem::path>& linkLibraries,
+        const BlockAST* root,
+        const std::string& initFunctionName,
+        const llvm::Module& module
+    );
+
+    const std::filesystem::path& getFilePath() const;
+    const std::vector<std::pair<std::filesystem::path, uint64_t>>& getSourceFiles() const;
+    const std::vector<std::filesystem::path>& getLinkLibraries() const;
+
+    /// @brief declarations for IRGenerator::generateInterface()
+    BlockAST* getInterface() const;
+
+    /// @brief structs of interface, they have to be known to parser
+    const std::vector<std::u8string>& getStructNames() const;
+    llvm::MemoryBufferRef getBitcode() const;
+};
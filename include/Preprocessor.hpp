@@ -8,38 +8,120 @@
 #include <algorithm>
 #include <iostream>
 #include <stack>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
+#include <optional>
 #include "ErrorHandler.hpp"
+#include "SourceManager.hpp"
+#include "PrecompiledModule.hpp"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 
 // It has a tree structure, where each node represents a file and its included files
 struct LoremSourceFile {
     std::filesystem::path filePath;
-    std::u8string sourceCode; // without apere
+    std::shared_ptr<const llvm::MemoryBuffer> buffer; // file as it is on disk, mapped read-only if possible
+    std::u8string_view sourceCode; // view of buffer, with apere
+    // [begin, end) of apere "fileName" directives in sourceCode, they aren't part of the code (\n stays)
+    std::vector<std::pair<size_t, size_t>> skippedRanges;
     // position (in node's sourceCode) and file that was included
     std::vector<std::pair<size_t, std::unique_ptr<LoremSourceFile>>> includedLorem;
 };
 
+// apere directive, found before the include tree is built
+struct IncludeDirective {
+    size_t begin; // [begin, end) of apere "fileName" in source code
+    size_t end;
+    std::filesystem::path includePath; // weakly canonical
+    std::u8string error; // directive is invalid, if not empty
+};
+
+// File read and scanned for apere directives (on thread pool), tree is built from it afterwards
+struct ScannedFile {
+    std::shared_ptr<const llvm::MemoryBuffer> buffer; // nullptr, if file couldn't be read
+    std::vector<IncludeDirective> includes;
+};
+
+using ScannedFileMap = std::unordered_map<std::string, std::unique_ptr<ScannedFile>>; // key is path
+
+// Content of a file as it was on disk at modification time
+struct CachedFile {
+    std::filesystem::file_time_type lastWriteTime;
+    std::shared_ptr<const llvm::MemoryBuffer> content;
+};
+
 class Preprocessor {
 private:
+    inline static bool s_fileCacheEnabled = false;
+    inline static std::unordered_map<std::string, CachedFile> s_fileCache; // key is canonical path
+    inline static std::mutex s_fileCacheMutex;
+    inline static std::atomic<unsigned> s_readThreads = 0; // 0 means one per hardware thread
+
     std::unique_ptr<LoremSourceFile> m_rootFile;
-    std::vector<std::filesystem::path> m_includedFiles;
+    std::vector<std::filesystem::path> m_includedFiles; // in order of inclusion, main file is first
+    std::unordered_set<std::string> m_includedFileSet; // paths of m_includedFiles, for fast lookup
     std::vector<std::filesystem::path> m_linkLibraries;
-    std::vector<SourceLine> m_mergedLines;
+    bool m_usePrecompiledModules;
+    std::vector<std::unique_ptr<PrecompiledModule>> m_precompiledModules; // used instead of their source files
+    SourceManager m_sources; // merged source code
 
 public:
-    Preprocessor(std::filesystem::path& mainFilePath);
+    /// @param onlyResolveIncludes stops after include tree is loaded, source code isn't merged (for dependency output)
+    /// @param usePrecompiledModules included file is replaced by it's fresh precompiled module (.lmod), if there is one
+    Preprocessor(const std::filesystem::path& mainFilePath, bool onlyResolveIncludes = false, bool usePrecompiledModules = true);
 
-    /// @brief This getter allows ErrorHandler to access origin lines of merged lines
-    const std::vector<SourceLine>& getMergedLines() const;
+    /// @brief This getter allows ErrorHandler to find origin of merged lines
+    const SourceManager& getSourceManager() const;
 
-    /// @brief This will just create string with all lines in it
-    std::u8string getMergedSourceCode() const;
+    /// @brief code of all files, included files are in place of their apere
+    const std::u8string& getMergedSourceCode() const;
 
     /// @brief libraries that have to be included by linker to executable
     const std::vector<std::filesystem::path>& getLinkLibs() const;
 
+    /// @brief modules, which are included instead of their source, their code isn't part of merged source code
+    const std::vector<std::unique_ptr<PrecompiledModule>>& getPrecompiledModules() const;
+
+    /// @brief main file, every included .lorem file, library and precompiled module once, in order of inclusion
+    const std::vector<std::filesystem::path>& getIncludedFiles() const;
+
+    /// @brief writes Makefile rule "target: included files" (like -MD -MP of gcc),
+    /// every included file also gets an empty rule, so make doesn't fail when it's deleted
+    void writeDependencies(std::ostream& ostr, const std::filesystem::path& target) const;
+
+    /// @brief every included .lorem file once, files before files that include them (main file is last)
+    std::vector<const LoremSourceFile*> getModuleUnits() const;
+
+    /// @brief adds file to outSources and appends it's code, 
+    /// code of included files is put in place of their apere, if withIncludedFiles
+    static void mergeFiles(const LoremSourceFile* file, bool withIncludedFiles, SourceManager& outSources);
+
+    /// @brief keeps read files in memory for next preprocessors (used by compile server),
+    /// file is read again only when it's modification time changes
+    static void enableFileCache(bool enable);
+
+    /// @brief limits threads reading included files of one preprocessor, 
+    /// so preprocessors running in parallel (-j) share the cores instead of each starting one thread per core
+    /// @param threads 0 means one per hardware thread
+    static void setReadThreads(unsigned threads);
+
 private:
-    std::unique_ptr<LoremSourceFile> createFileTree(std::filesystem::path& filePath, std::vector<std::filesystem::path>& includingStack);
-    static std::vector<SourceLine> mergeFiles(const LoremSourceFile* file);
-    static std::u8string readFileToU8String(std::filesystem::path& filePath);
-    static int countLines(const std::u8string& str, size_t untilPos);
+    struct Discovery;
+
+    /// @brief reads main file and every .lorem file included by it, sibling includes are read at the same time
+    static ScannedFileMap discoverFiles(const std::filesystem::path& mainFilePath);
+    static void discoverFile(const std::filesystem::path& filePath, Discovery& discovery);
+    static ScannedFile scanFile(const std::filesystem::path& filePath);
+
+    /// @brief builds tree from scanned files depth-first, in order of apere directives
+    std::unique_ptr<LoremSourceFile> createFileTree(const std::filesystem::path& filePath, const ScannedFileMap& scannedFiles, std::unordered_set<std::string>& includingFiles);
+
+    /// @return false, if there is no precompiled module for file, or it's stale, or some of it's files are already included
+    bool includePrecompiledModule(const std::filesystem::path& filePath, const ScannedFileMap& scannedFiles);
+    static void collectModuleUnits(const LoremSourceFile* file, std::vector<const LoremSourceFile*>& outUnits);
+    static std::shared_ptr<const llvm::MemoryBuffer> readFile(const std::filesystem::path& filePath);
+    static size_t countLines(std::u8string_view str, size_t fromPos, size_t untilPos);
+    static std::string escapeMakefilePath(const std::filesystem::path& path);
 };
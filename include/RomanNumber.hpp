@@ -1,72 +1,234 @@
 #pragma once
+#include <array>
+#include <climits>
+#include <cstdint>
 #include <string>
-
-struct ConvertData{
-    std::u8string romanNumeral;
-    int arabicNumeral;
-};
-
-inline static const ConvertData Units[] = {
-    {u8"VIII", 8},
-    {u8"VII", 7},
-    {u8"III", 3},
-    {u8"IX", 9},
-    {u8"VI", 6},
-    {u8"IV", 4},
-    {u8"II", 2},
-    {u8"V", 5},
-    {u8"I", 1}
-};
-
-inline static const ConvertData Tens[] = {
-    {u8"LXXX", 80},
-    {u8"LXX", 70},
-    {u8"XXX", 30},
-    {u8"XC", 90},
-    {u8"LX", 60},
-    {u8"XL", 40},
-    {u8"XX", 20},
-    {u8"L", 50},
-    {u8"X", 10}
-};
-
-
-inline static const ConvertData Hundreds[] = {
-    {u8"DCCC", 800},
-    {u8"DCC", 700},
-    {u8"CCC", 300},
-    {u8"CM", 900},
-    {u8"DC", 600},
-    {u8"CD", 400},
-    {u8"CC", 200},
-    {u8"D", 500},
-    {u8"C", 100}
-};
-
-inline static const std::u8string OrderedUnits[] = {
-    u8"I", u8"II", u8"III", u8"IV", u8"V", u8"VI", u8"VII", u8"VIII", u8"IX"
-};
-
-inline static const std::u8string OrderedTens[] = {
-    u8"X", u8"XX", u8"XXX", u8"XL", u8"L", u8"LX", u8"LXX", u8"LXXX", u8"XC"
+#include <string_view>
+
+enum class RomanNumberError {
+    NONE,
+    EMPTY,          // nothing after sign
+    INVALID_SYMBOL, // not I, V, X, L, C, D or M (or O and '_' where groups allow them)
+    NOT_CANONICAL,  // roman symbols in wrong order or count, e.g. IIII, IC, VX, MMMM, empty or needless groups
+    OUT_OF_RANGE,   // doesn't fit into requested integer type
 };
 
-
-inline static const std::u8string OrderedHundreds[] = {
-    u8"C", u8"CC", u8"CCC", u8"CD", u8"D", u8"DC", u8"DCC", u8"DCCC", u8"CM"
-};
-
-inline static const std::u8string OrderedThousands[] = {
-    u8"M", u8"MM", u8"MMM"
-};
-
-
-
-std::u8string toRomanConverter(int number);
-
-bool toArabicConverterAuto(std::u8string romanNumber, int* outArabic);
-
-bool toArabicConverter(std::u8string romanNumber, int* outArabic); 
-
-int subConverter(std::u8string& romanNumber, const ConvertData steps[]);
-
+// Tables for conversion in both directions. Numbers up to 3999 are written as usual,
+// larger numbers are written in groups of thousands, separated by '_' (as vinculum, every group is worth 1000 times the next one),
+// e.g. XLII_O_VII is 42 000 007. Groups are 0-999, so first group of 64-bit numbers is at most IX.
+namespace roman_number {
+    struct Decade {
+        char8_t one;
+        char8_t five;
+        char8_t ten;
+        int value;
+    };
+
+    // every decade except thousands, which are just M{0,3}
+    inline constexpr Decade DECADES[] = {
+        {u8'C', u8'D', u8'M', 100},
+        {u8'X', u8'L', u8'C', 10},
+        {u8'I', u8'V', u8'X', 1},
+    };
+
+    // [thousands, hundreds, tens, units][digit]
+    inline constexpr std::u8string_view DIGITS[4][10] = {
+        {u8"", u8"M", u8"MM", u8"MMM"},
+        {u8"", u8"C", u8"CC", u8"CCC", u8"CD", u8"D", u8"DC", u8"DCC", u8"DCCC", u8"CM"},
+        {u8"", u8"X", u8"XX", u8"XXX", u8"XL", u8"L", u8"LX", u8"LXX", u8"LXXX", u8"XC"},
+        {u8"", u8"I", u8"II", u8"III", u8"IV", u8"V", u8"VI", u8"VII", u8"VIII", u8"IX"},
+    };
+
+    inline constexpr int MAX_VALUE = 3999; // largest number without groups
+    inline constexpr uint64_t GROUP_BASE = 1000;
+    inline constexpr size_t MAX_GROUPS = 7; // 9 223 372 036 854 775 808
+    inline constexpr char8_t GROUP_SEPARATOR = u8'_';
+    inline constexpr std::u8string_view ZERO = u8"O";
+
+    constexpr bool isSymbol(char8_t character) {
+        return character == u8'I' || character == u8'V' || character == u8'X' || character == u8'L'
+            || character == u8'C' || character == u8'D' || character == u8'M';
+    }
+
+    /// @brief reads M{0,maxThousands} and decades of canonical number, starting at index
+    /// @return index after last read symbol
+    constexpr size_t parseDecades(std::u8string_view romanNumber, size_t index, int maxThousands, uint64_t* outValue) {
+        auto isAt = [&romanNumber](size_t i, char8_t character) {
+            return i < romanNumber.size() && romanNumber[i] == character;
+        };
+
+        uint64_t value = 0;
+        for (int thousands = 0; thousands < maxThousands && isAt(index, u8'M'); thousands++, index++) {
+            value += 1000;
+        }
+
+        for (const Decade& decade : DECADES) {
+            // 9 and 4 are written by subtraction
+            if (isAt(index, decade.one) && isAt(index + 1, decade.ten)) {
+                value += 9 * decade.value;
+                index += 2;
+                continue;
+            }
+            if (isAt(index, decade.one) && isAt(index + 1, decade.five)) {
+                value += 4 * decade.value;
+                index += 2;
+                continue;
+            }
+
+            int digit = 0;
+            if (isAt(index, decade.five)) {
+                digit = 5;
+                index++;
+            }
+            for (int ones = 0; ones < 3 && isAt(index, decade.one); ones++, index++) {
+                digit++;
+            }
+            value += digit * decade.value;
+        }
+
+        *outValue = value;
+        return index;
+    }
+}
+
+// "-VIII_DCCCLXXXVIII_DCCCLXXXVIII_..." (-8 888 888 888 888 888 888) is the longest
+using RomanBuffer = std::array<char8_t, 1 + 4 + (roman_number::MAX_GROUPS - 1) * 13>;
+
+/// @brief converts number into buffer, numbers above 3999 are written in groups of thousands
+/// @return view of buffer (or of static string), valid as long as buffer is
+constexpr std::u8string_view toRomanConverter(int64_t number, RomanBuffer& buffer) {
+    if (number == 0) {
+        return roman_number::ZERO;
+    }
+
+    size_t length = 0;
+    auto append = [&buffer, &length](std::u8string_view text) {
+        for (char8_t character : text) {
+            buffer[length++] = character;
+        }
+    };
+
+    // -INT64_MIN doesn't fit into int64_t
+    uint64_t magnitude = number < 0 ? 0 - static_cast<uint64_t>(number) : static_cast<uint64_t>(number);
+    if (number < 0) {
+        append(u8"-");
+    }
+
+    if (magnitude <= roman_number::MAX_VALUE) {
+        append(roman_number::DIGITS[0][magnitude / 1000]);
+        append(roman_number::DIGITS[1][magnitude / 100 % 10]);
+        append(roman_number::DIGITS[2][magnitude / 10 % 10]);
+        append(roman_number::DIGITS[3][magnitude % 10]);
+        return std::u8string_view(buffer.data(), length);
+    }
+
+    std::array<uint64_t, roman_number::MAX_GROUPS> groups{};
+    size_t groupCount = 0;
+    for (; magnitude != 0; magnitude /= roman_number::GROUP_BASE) {
+        groups[groupCount++] = magnitude % roman_number::GROUP_BASE;
+    }
+    for (size_t i = groupCount; i-- > 0;) {
+        if (i != groupCount - 1) {
+            buffer[length++] = roman_number::GROUP_SEPARATOR;
+        }
+        if (groups[i] == 0) {
+            append(roman_number::ZERO);
+            continue;
+        }
+        append(roman_number::DIGITS[1][groups[i] / 100]);
+        append(roman_number::DIGITS[2][groups[i] / 10 % 10]);
+        append(roman_number::DIGITS[3][groups[i] % 10]);
+    }
+    return std::u8string_view(buffer.data(), length);
+}
+
+std::u8string toRomanConverter(int64_t number);
+
+/// @brief converts canonical roman number (optionally with '-' in front, O for zero, groups of thousands above 3999) in one pass
+/// @return NONE on success, outArabic is 0 otherwise
+constexpr RomanNumberError parseRomanNumber(std::u8string_view romanNumber, int64_t* outArabic) {
+    *outArabic = 0;
+    if (romanNumber == roman_number::ZERO) {
+        return RomanNumberError::NONE;
+    }
+
+    const bool isNegative = !romanNumber.empty() && romanNumber[0] == u8'-';
+    size_t i = isNegative ? 1 : 0;
+    if (i == romanNumber.size()) {
+        return RomanNumberError::EMPTY;
+    }
+
+    const uint64_t limit = static_cast<uint64_t>(INT64_MAX) + (isNegative ? 1 : 0);
+    uint64_t magnitude = 0;
+    uint64_t firstGroup = 0;
+    size_t groupCount = 0;
+    while (true) {
+        uint64_t group = 0;
+        size_t groupStart = i;
+        if (groupCount > 0 && romanNumber.substr(i, roman_number::ZERO.size()) == roman_number::ZERO) {
+            i += roman_number::ZERO.size();
+        } else {
+            // only number without groups may have thousands
+            i = roman_number::parseDecades(romanNumber, i, groupCount == 0 ? 3 : 0, &group);
+        }
+        if (i == groupStart) {
+            if (groupCount > 0) {
+                return RomanNumberError::NOT_CANONICAL; // empty group
+            }
+            break;
+        }
+
+        if (magnitude > (limit - group) / roman_number::GROUP_BASE) {
+            return RomanNumberError::OUT_OF_RANGE;
+        }
+        magnitude = magnitude * roman_number::GROUP_BASE + group;
+        firstGroup = groupCount == 0 ? group : firstGroup;
+        groupCount++;
+
+        if (i == romanNumber.size() || romanNumber[i] != roman_number::GROUP_SEPARATOR) {
+            break;
+        }
+        i++;
+    }
+
+    if (i != romanNumber.size()) {
+        return roman_number::isSymbol(romanNumber[i]) ? RomanNumberError::NOT_CANONICAL : RomanNumberError::INVALID_SYMBOL;
+    }
+    // every number has only one spelling: thousands only without groups, no groups up to 3999
+    if (groupCount > 1 && (firstGroup >= roman_number::GROUP_BASE || magnitude <= roman_number::MAX_VALUE)) {
+        return RomanNumberError::NOT_CANONICAL;
+    }
+
+    *outArabic = static_cast<int64_t>(isNegative ? 0 - magnitude : magnitude);
+    return RomanNumberError::NONE;
+}
+
+/// @brief same as above, but number has to fit into int
+constexpr RomanNumberError parseRomanNumber(std::u8string_view romanNumber, int* outArabic) {
+    int64_t arabic = 0;
+    RomanNumberError error = parseRomanNumber(romanNumber, &arabic);
+    if (error == RomanNumberError::NONE && (arabic < INT_MIN || arabic > INT_MAX)) {
+        error = RomanNumberError::OUT_OF_RANGE;
+    }
+    *outArabic = error == RomanNumberError::NONE ? static_cast<int>(arabic) : 0;
+    return error;
+}
+
+/// @return false, if romanNumber isn't canonical roman number (see parseRomanNumber)
+constexpr bool toArabicConverter(std::u8string_view romanNumber, int64_t* outArabic) {
+    return parseRomanNumber(romanNumber, outArabic) == RomanNumberError::NONE;
+}
+
+constexpr bool toArabicConverter(std::u8string_view romanNumber, int* outArabic) {
+    return parseRomanNumber(romanNumber, outArabic) == RomanNumberError::NONE;
+}
+
+namespace roman_number {
+    consteval bool isRoundTrip(int64_t number) {
+        RomanBuffer buffer{};
+        int64_t arabic = 0;
+        return toArabicConverter(toRomanConverter(number, buffer), &arabic) && arabic == number;
+    }
+    static_assert(isRoundTrip(0) && isRoundTrip(1) && isRoundTrip(-3888) && isRoundTrip(3999) && isRoundTrip(1994));
+    static_assert(isRoundTrip(4000) && isRoundTrip(1000000) && isRoundTrip(-8888888888888888888) && isRoundTrip(INT64_MIN) && isRoundTrip(INT64_MAX));
+}
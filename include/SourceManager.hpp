@@ -0,0 +1,64 @@
+#pragma once
+#include <assert.h>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using FileId = uint32_t;
+
+// Where a line of merged source code comes from
+struct SourceLocation {
+    FileId file;
+    size_t lineIndexInFile;
+};
+
+// Keeps every source file once (as a view of it's buffer) with offsets of it's lines,
+// and the merged source code, which is made of line ranges of these files.
+// Merged lines are mapped back to files by a table of line ranges, not by a copy of every line.
+class SourceManager {
+private:
+    struct File {
+        std::filesystem::path filePath;
+        std::u8string_view sourceCode; // NOTE: isn't owned, buffer has to outlive source manager
+        std::vector<size_t> lineOffsets; // begin of every line, last line doesn't end with \n
+    };
+
+    // Consecutive lines of one file in merged source code
+    struct Chunk {
+        size_t mergedLine; // index of first line in merged source code
+        FileId file;
+        size_t firstLine; // index of first line in file
+    };
+
+    std::vector<File> m_files;
+    std::vector<Chunk> m_chunks; // ordered by mergedLine
+    size_t m_mergedLineCount;
+    std::u8string m_mergedCode;
+
+public:
+    SourceManager();
+
+    /// @brief registers file and finds it's lines
+    /// @return id of file, sourceCode has to stay valid while source manager is used
+    FileId addFile(const std::filesystem::path& filePath, std::u8string_view sourceCode);
+
+    /// @brief appends lines [firstLine, endLine) of file to merged source code, bytes in skippedRanges are left out
+    /// @param skippedRanges sorted [begin, end) offsets in file, which don't contain \n
+    void appendLines(FileId file, size_t firstLine, size_t endLine, const std::vector<std::pair<size_t, size_t>>& skippedRanges = {});
+
+    /// @brief every line of merged source code ends with \n
+    const std::u8string& getMergedCode() const;
+
+    size_t getLineCount(FileId file) const;
+
+    const std::filesystem::path& getFilePath(FileId file) const;
+
+    /// @return text of line as it is in the file (with \n, if there is one)
+    std::u8string_view getLine(FileId file, size_t lineIndex) const;
+
+    /// @param mergedLine index of line in merged source code
+    SourceLocation getLocation(size_t mergedLine) const;
+};
@@ -1,7 +1,7 @@
 #pragma once
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include "Token.hpp"
 
 namespace punctuation {
     inline constexpr std::u8string_view PAREN_OPEN = u8"(";
@@ -40,13 +40,14 @@ namespace keywords {
 
 namespace types {
     inline constexpr std::u8string_view INT = u8"numerus";
+    inline constexpr std::u8string_view LONG = u8"magnus";
     inline constexpr std::u8string_view BOOL = u8"asertio";
     inline constexpr std::u8string_view CHAR = u8"litera";
     inline constexpr std::u8string_view VOID = u8"nihil";
     inline constexpr std::u8string_view STRUCT = u8"rerum";
 
     inline constexpr std::u8string_view VALUES[] = {
-        INT, BOOL, CHAR, VOID, STRUCT
+        INT, LONG, BOOL, CHAR, VOID, STRUCT
     };
     inline constexpr size_t VALUES_SIZE = sizeof(VALUES) / sizeof(VALUES[0]); 
 }
@@ -87,31 +88,44 @@ namespace operators {
     inline constexpr size_t VALUES_SIZE = sizeof(VALUES) / sizeof(VALUES[0]); 
 
     // source: https://en.wikipedia.org/wiki/Order_of_operations
-    // smaller number means higher priority
-    inline const std::unordered_map<std::u8string_view, int> BINARY_OPERATION_PRIORITY_MAP = {
-        {FACTORIAL, 2},
-        {NOT, 2},
-        {POWER, 2},
-
-        {MULTIPLY, 3},
-        {DIVIDE, 3},
-        {MODULO, 3},
-
-        {PLUS, 4},
-        {MINUS, 4},
-
-        {LESSER, 6},
-        {GREATER_OR_EQUAL, 6},
-        {LESSER_OR_EQUAL, 6},
-        {GREATER, 6},
-
-        {EQUAL, 7},
-        {NOT_EQUAL, 7},
-
-        {AND, 11},
-
-        {OR, 12},
-
-        {ASSIGN, 14},
-    };
-}
+    // smaller number means higher priority, -1 if kind isn't a binary operator
+    constexpr int getBinaryOperationPriority(TokenKind kind) {
+        switch (kind) {
+            case TokenKind::FACTORIAL:
+            case TokenKind::NOT:
+            case TokenKind::POWER:
+                return 2;
+
+            case TokenKind::MULTIPLY:
+            case TokenKind::DIVIDE:
+            case TokenKind::MODULO:
+                return 3;
+
+            case TokenKind::PLUS:
+            case TokenKind::MINUS:
+                return 4;
+
+            case TokenKind::LESSER:
+            case TokenKind::GREATER_OR_EQUAL:
+            case TokenKind::LESSER_OR_EQUAL:
+            case TokenKind::GREATER:
+                return 6;
+
+            case TokenKind::EQUAL:
+            case TokenKind::NOT_EQUAL:
+                return 7;
+
+            case TokenKind::AND:
+                return 11;
+
+            case TokenKind::OR:
+                return 12;
+
+            case TokenKind::ASSIGN:
+                return 14;
+
+            default:
+                return -1;
+        }
+    }
+}
\ No newline at end of file
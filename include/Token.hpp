@@ -1,5 +1,6 @@
 #pragma once
-#include <string>
+#include <cstdint>
+#include <string_view>
 
 enum class TokenType {
     EOF_TOKEN,      // End of the file
@@ -29,7 +30,35 @@ inline const char* TOKEN_TYPE_LABELS[] = {
     "NEW_LINE",
 };
 
+// Which fixed word of Syntax.hpp the token is, parser dispatches on it instead of comparing strings.
+// Names match the constants in Syntax.hpp.
+enum class TokenKind : uint8_t {
+    NONE,           // identifiers, numbers, literals, strings, new lines and end of the file
+
+    // punctuation
+    PAREN_OPEN, PAREN_CLOSE, BLOCK_OPEN, BLOCK_CLOSE,
+    COMMA, SQR_BRACKET_OPEN, SQR_BRACKET_CLOSE, APOSTROPHE, QUOTE,
+
+    // boolean_types
+    TRUE, FALSE,
+
+    // keywords
+    FUNCTION, RETURN, BREAK, FOR_LOOP,
+    IF, ELIF, ELSE, INCLUDE,
+
+    // types
+    INT, LONG, BOOL, CHAR, VOID, STRUCT,
+
+    // operators
+    ASSIGN, EQUAL, NOT_EQUAL, GREATER, LESSER,
+    GREATER_OR_EQUAL, LESSER_OR_EQUAL, PLUS, MINUS,
+    MULTIPLY, DIVIDE, MODULO, POWER, NOT,
+    FACTORIAL, AND, OR,
+};
+
 struct Token {
     TokenType type;
-    std::u8string value; 
+    std::u8string_view value;               // points into source code given to Lexer, which has to outlive the tokens
+    TokenKind kind = TokenKind::NONE;
+    uint32_t identifierId = 0;              // same for every occurrence of an identifier in one source, 0 for other tokens
 };
@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <iostream>
+#include <vector>
+#include "Lexer.hpp"
+#include "Token.hpp"
+
+/// @brief Tokens for Parser, pulled from Lexer on demand into small lookahead buffer,
+/// so memory doesn't grow with count of tokens in the file.
+class TokenStream {
+public:
+    static constexpr size_t LOOKAHEAD = 4; // power of two, so ring buffer index is a mask
+
+private:
+    Lexer* m_lexer;                     // nullptr, if tokens were lexed beforehand
+    const std::vector<Token>* m_tokens; // nullptr, if tokens are pulled from lexer
+    size_t m_tokenIndex;                // next token of m_tokens to be buffered
+    std::ostream& m_ostr;               // debug output of tokens
+    bool m_isFinished;                  // EOF_TOKEN was buffered, lexer isn't asked anymore
+
+    std::array<Token, LOOKAHEAD> m_buffer;
+    size_t m_head; // index of current token in m_buffer
+    size_t m_size; // count of buffered tokens, current token included, lexer is asked lazily
+
+public:
+    TokenStream(Lexer& lexer, std::ostream& ostr);
+
+    /// @brief stream of already lexed tokens, vector has to end with EOF_TOKEN
+    TokenStream(const std::vector<Token>& tokens);
+
+    /// @return current token, valid until stream is advanced
+    const Token& current();
+
+    /// @brief moves to next token, stays at EOF_TOKEN once it's reached
+    /// @return new current token
+    const Token& advance();
+
+    /// @return token offset places after current one, offset has to be smaller than LOOKAHEAD
+    const Token& peek(size_t offset);
+
+private:
+    /// @brief buffers tokens until there are at least count of them
+    void fill(size_t count);
+    void fillSlow(size_t count);
+    void pull(Token& outToken);
+};
+
+// NOTE: called for every token by parser, inlined in the header
+
+inline const Token& TokenStream::current() {
+    fill(1);
+    return m_buffer[m_head];
+}
+
+inline const Token& TokenStream::advance() {
+    fill(1);
+    m_head = (m_head + 1) & (LOOKAHEAD - 1);
+    m_size--;
+    return current();
+}
+
+inline void TokenStream::fill(size_t count) {
+    if (m_size < count) {
+        fillSlow(count);
+    }
+}
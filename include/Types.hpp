@@ -6,11 +6,12 @@
 #include "Syntax.hpp"
 
 enum class PrimitiveType {
-    INT, BOOL, CHAR, VOID
+    INT, LONG, BOOL, CHAR, VOID
 };
 
 inline const std::unordered_map<std::u8string_view, PrimitiveType> STR_TO_PRIMITIVE_MAP = {
     { types::INT, PrimitiveType::INT },
+    { types::LONG, PrimitiveType::LONG },
     { types::BOOL, PrimitiveType::BOOL },
     { types::CHAR, PrimitiveType::CHAR },
     { types::VOID, PrimitiveType::VOID }
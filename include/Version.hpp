@@ -0,0 +1,8 @@
+#pragma once
+#include <string>
+
+inline constexpr const char* LSC_VERSION = "0.1";
+
+/// @brief version of lsc and LLVM and hash of the running lsc executable.
+/// It's part of every cache key and precompiled module, so artifacts of other compiler builds are never reused.
+const std::string& getCompilerIdentity();
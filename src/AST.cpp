@@ -19,14 +19,19 @@ BlockAST::BlockAST(std::vector<std::unique_ptr<AST>> instructions, size_t line)
     : m_instructions(std::move(instructions))
     , m_line(line) {}
 
+const std::vector<std::unique_ptr<AST>>& BlockAST::getInstructions() const {
+    return m_instructions;
+}
+
 
-NumberAST::NumberAST(int value, size_t line) 
+NumberAST::NumberAST(int64_t value, size_t line) 
     : m_value(value)
     , m_line(line) {}
 
 const IDataType* NumberAST::getType([[maybe_unused]] const IRContext& context) {
     static const std::unique_ptr<IDataType> TYPE = std::make_unique<PrimitiveDataType>(PrimitiveType::INT);
-    return TYPE.get();
+    static const std::unique_ptr<IDataType> LONG_TYPE = std::make_unique<PrimitiveDataType>(PrimitiveType::LONG);
+    return isLong() ? LONG_TYPE.get() : TYPE.get();
 }
 
 CharAST::CharAST(char8_t character, size_t line) 
@@ -107,6 +112,10 @@ const IDataType* VariableDeclarationAST::getType([[maybe_unused]] const IRContex
     return m_type.get();
 }
 
+const IDataType* VariableDeclarationAST::getDataType() const {
+    return m_type.get();
+}
+
 VariableReferenceAST::VariableReferenceAST(const std::u8string& name, size_t line)
     : m_name(std::move(name)), m_line(line) {}
 
@@ -124,8 +133,16 @@ BinaryOperatorAST::BinaryOperatorAST(const std::u8string& op, std::unique_ptr<AS
     , m_RHS(std::move(RHS))
     , m_line(line) {}
 
-const IDataType* BinaryOperatorAST::getType([[maybe_unused]] const IRContext& context) {
-    return m_LHS->getType(context);
+const IDataType* BinaryOperatorAST::getType(const IRContext& context) {
+    // numerus is promoted to magnus, if other side is magnus
+    const IDataType* leftType = m_LHS->getType(context);
+    auto leftPrimitive = dynamic_cast<const PrimitiveDataType*>(leftType);
+    if (m_op != operators::ASSIGN && leftPrimitive && leftPrimitive->type == PrimitiveType::INT) {
+        auto rightPrimitive = dynamic_cast<const PrimitiveDataType*>(m_RHS->getType(context));
+        if (rightPrimitive && rightPrimitive->type == PrimitiveType::LONG)
+            return rightPrimitive;
+    }
+    return leftType;
 }
 
 std::unique_ptr<AST>* BinaryOperatorAST::getLHS() {
@@ -168,6 +185,10 @@ const std::vector<std::unique_ptr<TypeIdentifierPair>>& FunctionPrototypeAST::ge
     return m_args;
 }
 
+const IDataType* FunctionPrototypeAST::getReturnType() const {
+    return m_returnType.get();
+}
+
 bool FunctionPrototypeAST::isDefined() const {
     return m_isDefined;
 }
@@ -185,6 +206,10 @@ const IDataType* FunctionAST::getType(const IRContext& context) {
     return m_prototype->getType(context);
 }
 
+const FunctionPrototypeAST* FunctionAST::getPrototype() const {
+    return m_prototype.get();
+}
+
 ReturnAST::ReturnAST(std::unique_ptr<AST> expr, size_t line) 
     : m_expr(std::move(expr))
     , m_line(line) {}
@@ -233,7 +258,7 @@ const IDataType* AccessArrayElementAST::getType(const IRContext& context) {
     if (structType) {
         const NumberAST* index = dynamic_cast<const NumberAST*>(m_index.get());
         if (index) {
-            if (index->getValue() < 0 || index->getValue() >= (int)structType->attributes.size()) {
+            if (index->getValue() < 0 || index->getValue() >= (int64_t)structType->attributes.size()) {
                 ErrorHandler::logError(u8"Syntax Error: Index out of bounds for '" + m_name + u8"' struct!", m_line);
                 return nullptr;
             }
@@ -263,6 +288,10 @@ const IDataType* StructAST::getType([[maybe_unused]] const IRContext &context) {
     return m_type.get();
 }
 
+const StructDataType* StructAST::getStructType() const {
+    return m_type.get();
+}
+
 //===----------------------------------------------------------------------===//
 // Printing AST Tree
 //===----------------------------------------------------------------------===//
@@ -298,10 +327,14 @@ size_t NumberAST::getLine() const {
     return m_line;
 }
 
-int NumberAST::getValue() const {
+int64_t NumberAST::getValue() const {
     return m_value;
 }
 
+bool NumberAST::isLong() const {
+    return m_value < INT32_MIN || m_value > INT32_MAX;
+}
+
 void CharAST::printTree(std::ostream& ostr, const std::string& indent, bool isLast) const {
     printIndent(ostr, indent, isLast);
     ostr << "CharAST('" << (char)m_char << "')" << std::endl;
@@ -1,11 +1,188 @@
 #include "Assembler.hpp"
 
-void Assembler::compileToObjectFile(const std::filesystem::path& objectFilePath, Module* module, CodeGenFileType fileType) {
-	LLVMInitializeX86TargetInfo();
-    LLVMInitializeX86Target();
-    LLVMInitializeX86TargetMC();
-    LLVMInitializeX86AsmParser();
-    LLVMInitializeX86AsmPrinter();
+// NOTE: Messages go to output of the compilation on this thread, so parallel compilations (-j) print them grouped by file
+static raw_os_ostream errorOutput() {
+	return raw_os_ostream(ErrorHandler::getOutput());
+}
+
+Assembler::Assembler()
+	: m_irCode(nullptr)
+	, m_options() {}
+
+Assembler::Assembler(const CodeGenOptions& options)
+	: m_irCode(nullptr)
+	, m_options(options) {}
+
+bool Assembler::compileToObjectFile(const std::filesystem::path& objectFilePath, Module* module, CodeGenFileType fileType) {
+	std::unique_ptr<TargetMachine> TheTargetMachine = createTargetMachine(module);
+	if (!TheTargetMachine) {
+		return false;
+	}
+
+	optimizeModule(module, TheTargetMachine.get());
+
+	// NOTE: In lto mode "object" contains bitcode, machine code is generated by linker
+	if (m_options.lto != LTOMode::None && fileType == CodeGenFileType::ObjectFile) {
+		TimeTraceScope scope("Emit bitcode", objectFilePath.string());
+		std::error_code errorCode;
+		raw_fd_ostream dest(objectFilePath.string(), errorCode, sys::fs::OF_None);
+		if (errorCode) {
+			errorOutput() << "Could not open file: " << errorCode.message() << "\n";
+			return false;
+		}
+		emitBitcode(dest, module);
+		return true;
+	}
+
+	if (!emitFile(objectFilePath, module, TheTargetMachine.get(), fileType)) {
+		return false;
+	}
+
+    #if !defined(NDEBUG)
+	if (fileType != CodeGenFileType::AssemblyFile) {
+		std::filesystem::path asmFilePath = objectFilePath.parent_path() / objectFilePath.stem();
+		asmFilePath += ".asm";
+		emitFile(asmFilePath, module, TheTargetMachine.get(), CodeGenFileType::AssemblyFile);
+	}
+	#endif
+	return true;
+}
+
+bool Assembler::compileToObjectFiles(const std::filesystem::path& objectFilePath, Module* module, std::vector<std::filesystem::path>* outObjectFilePaths) {
+	// NOTE: With lto linker splits the work itself (--lto-partitions, --thinlto-jobs)
+	if (m_options.codegenThreads <= 1 || m_options.lto != LTOMode::None) {
+		outObjectFilePaths->push_back(objectFilePath);
+		return compileToObjectFile(objectFilePath, module, CodeGenFileType::ObjectFile);
+	}
+
+	std::vector<ObjectBuffer> objectBuffers;
+	if (!compileToObjectBuffers(&objectBuffers, module)) {
+		return false;
+	}
+
+	// First partition is written to objectFilePath, others get it's index: name-1.o, name-2.o, ...
+	for (size_t i = 0; i < objectBuffers.size(); i++) {
+		std::filesystem::path partitionFilePath = objectFilePath;
+		if (i > 0) {
+			partitionFilePath = objectFilePath.parent_path() / objectFilePath.stem();
+			partitionFilePath += "-" + std::to_string(i) + ".o";
+		}
+
+		// NOTE: Every partition is needed, linking without one of them would fail with undefined symbols
+		std::error_code errorCode;
+		raw_fd_ostream dest(partitionFilePath.string(), errorCode, sys::fs::OF_None);
+		if (errorCode) {
+			errorOutput() << "Could not open file " << partitionFilePath.string() << ": " << errorCode.message() << "\n";
+			return false;
+		}
+		dest.write(objectBuffers[i].data(), objectBuffers[i].size());
+		outObjectFilePaths->push_back(partitionFilePath);
+	}
+	return true;
+}
+
+bool Assembler::compileToObjectBuffers(std::vector<ObjectBuffer>* outBuffers, Module* module) {
+	std::unique_ptr<TargetMachine> TheTargetMachine = createTargetMachine(module);
+	if (!TheTargetMachine) {
+		return false;
+	}
+
+	optimizeModule(module, TheTargetMachine.get());
+
+	if (m_options.lto != LTOMode::None) {
+		TimeTraceScope scope("Emit bitcode", "<memory>");
+		outBuffers->resize(1);
+		raw_svector_ostream dest(outBuffers->front());
+		emitBitcode(dest, module);
+		return true;
+	}
+
+	if (m_options.codegenThreads > 1) {
+		return emitPartitions(outBuffers, module);
+	}
+
+	TimeTraceScope scope("Emit object", "<memory>");
+	outBuffers->resize(1);
+	raw_svector_ostream dest(outBuffers->front());
+	return emit(dest, module, TheTargetMachine.get(), CodeGenFileType::ObjectFile);
+}
+
+bool Assembler::emitPartitions(std::vector<ObjectBuffer>* outBuffers, Module* module) const {
+	TimeTraceScope scope("Emit partitions", std::to_string(m_options.codegenThreads));
+
+	// NOTE: Partitions share context of module, which can't be used from several threads. 
+	//       So every partition is serialized and loaded into it's own context on worker thread.
+	std::vector<SmallString<0>> partitions;
+	SplitModule(*module, m_options.codegenThreads, [&](std::unique_ptr<Module> partition) {
+		SmallString<0> bitcode;
+		raw_svector_ostream bitcodeStream(bitcode);
+		WriteBitcodeToFile(*partition, bitcodeStream);
+		partitions.push_back(std::move(bitcode));
+	});
+
+	outBuffers->resize(partitions.size());
+	std::vector<std::ostringstream> partitionOutputs(partitions.size());
+	std::vector<char> results(partitions.size(), false);
+	{
+		DefaultThreadPool threadPool(hardware_concurrency(m_options.codegenThreads));
+		for (size_t i = 0; i < partitions.size(); i++) {
+			threadPool.async([&, i]() {
+				// Worker has it's own ErrorHandler, it's messages are printed by calling thread
+				ErrorHandler::setOutput(&partitionOutputs[i]);
+				results[i] = emitPartition(partitions[i].str(), &(*outBuffers)[i]);
+				ErrorHandler::setOutput(&std::cerr);
+			});
+		}
+		threadPool.wait();
+	}
+
+	// Empty buffer of failed partition would end in obscure link error, so whole emission fails
+	std::ostream& output = ErrorHandler::getOutput();
+	bool success = true;
+	for (size_t i = 0; i < partitions.size(); i++) {
+		output << partitionOutputs[i].str();
+		if (!results[i]) {
+			output << "Error: Couldn't emit partition " << i << " of " << partitions.size() << std::endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+bool Assembler::emitPartition(StringRef bitcode, ObjectBuffer* outBuffer) const {
+	LLVMContext context;
+	auto partition = parseBitcodeFile(MemoryBufferRef(bitcode, "partition"), context);
+	if (!partition) {
+		errorOutput() << "Error: Couldn't load partition: " << toString(partition.takeError()) << "\n";
+		return false;
+	}
+
+	std::unique_ptr<TargetMachine> targetMachine = createTargetMachine(partition->get());
+	if (!targetMachine) {
+		return false;
+	}
+	raw_svector_ostream dest(*outBuffer);
+	return emit(dest, partition->get(), targetMachine.get(), CodeGenFileType::ObjectFile);
+}
+
+bool Assembler::canLinkAgain() {
+	std::lock_guard<std::mutex> lock(s_linkerMutex);
+	return s_canLinkAgain;
+}
+
+void Assembler::initializeTargets() {
+	static std::once_flag initialized;
+	std::call_once(initialized, []() {
+		LLVMInitializeX86TargetInfo();
+		LLVMInitializeX86Target();
+		LLVMInitializeX86TargetMC();
+		LLVMInitializeX86AsmParser();
+		LLVMInitializeX86AsmPrinter();
+	});
+}
+
+std::unique_ptr<TargetMachine> Assembler::createTargetMachine(Module* module) const {
+	initializeTargets();
 
 	std::string targetTriple;
 
@@ -23,43 +200,166 @@ void Assembler::compileToObjectFile(const std::filesystem::path& objectFilePath,
 	auto target = TargetRegistry::lookupTarget(targetTriple, Error);
 
 	if (!target) {
-		llvm::errs() << Error;
-		return;
+		errorOutput() << Error << "\n";
+		return nullptr;
 	}
 
-	auto cpu = "generic";
-	auto features = "";
+	std::string cpu;
+	std::string features;
+	getTargetCpuAndFeatures(&cpu, &features);
 
 	TargetOptions opt;
-	auto TheTargetMachine = target->createTargetMachine(targetTriple, cpu, features, opt, Reloc::PIC_);
+	std::unique_ptr<TargetMachine> TheTargetMachine(target->createTargetMachine(
+		targetTriple, cpu, features, opt, m_options.relocModel, m_options.codeModel, getCodeGenOptLevel(m_options.optLevel)
+	));
 
 	module->setDataLayout(TheTargetMachine->createDataLayout());
+	return TheTargetMachine;
+}
+
+bool Assembler::parseOptimizationLevel(const std::string_view& arg, OptimizationLevel* outLevel) {
+	if (arg == "-O0") *outLevel = OptimizationLevel::O0;
+	else if (arg == "-O1") *outLevel = OptimizationLevel::O1;
+	else if (arg == "-O2") *outLevel = OptimizationLevel::O2;
+	else if (arg == "-O3") *outLevel = OptimizationLevel::O3;
+	else return false;
+	return true;
+}
+
+bool Assembler::parseRelocModel(const std::string_view& value, Reloc::Model* outModel) {
+	if (value == "pic") *outModel = Reloc::PIC_;
+	else if (value == "static") *outModel = Reloc::Static;
+	else return false;
+	return true;
+}
+
+bool Assembler::parseCodeModel(const std::string_view& value, CodeModel::Model* outModel) {
+	if (value == "small") *outModel = CodeModel::Small;
+	else if (value == "kernel") *outModel = CodeModel::Kernel;
+	else if (value == "medium") *outModel = CodeModel::Medium;
+	else if (value == "large") *outModel = CodeModel::Large;
+	else return false;
+	return true;
+}
+
+bool Assembler::parseLTOMode(const std::string_view& value, LTOMode* outMode) {
+	if (value == "full") *outMode = LTOMode::Full;
+	else if (value == "thin") *outMode = LTOMode::Thin;
+	else return false;
+	return true;
+}
+
+void Assembler::getTargetCpuAndFeatures(std::string* outCpu, std::string* outFeatures) const {
+	if (m_options.targetCpu != "native") {
+		*outCpu = m_options.targetCpu;
+		*outFeatures = "";
+		return;
+	}
+
+	*outCpu = sys::getHostCPUName().str();
+
+	SubtargetFeatures features;
+	for (const auto& feature : sys::getHostCPUFeatures()) {
+		features.AddFeature(feature.first(), feature.second);
+	}
+	*outFeatures = features.getString();
+}
+
+void Assembler::optimizeModule(Module* module, TargetMachine* targetMachine) {
+	TimeTraceScope scope("Optimize");
+
+	// NOTE: Analysis managers must be declared in this order, so they are destroyed in the right order
+	LoopAnalysisManager loopAnalysisManager;
+	FunctionAnalysisManager functionAnalysisManager;
+	CGSCCAnalysisManager cgsccAnalysisManager;
+	ModuleAnalysisManager moduleAnalysisManager;
+
+	// Reports every pass as a separate scope, if time trace is enabled
+	PassInstrumentationCallbacks instrumentationCallbacks;
+	StandardInstrumentations standardInstrumentations(module->getContext(), false);
+	standardInstrumentations.registerCallbacks(instrumentationCallbacks, &moduleAnalysisManager);
+
+	PassBuilder passBuilder(targetMachine, PipelineTuningOptions(), std::nullopt, &instrumentationCallbacks);
+	passBuilder.registerModuleAnalyses(moduleAnalysisManager);
+	passBuilder.registerCGSCCAnalyses(cgsccAnalysisManager);
+	passBuilder.registerFunctionAnalyses(functionAnalysisManager);
+	passBuilder.registerLoopAnalyses(loopAnalysisManager);
+	passBuilder.crossRegisterProxies(loopAnalysisManager, functionAnalysisManager, cgsccAnalysisManager, moduleAnalysisManager);
+
+	// NOTE: Pre-link pipelines leave out passes, which are run by linker on the whole program
+	ModulePassManager modulePassManager;
+	if (m_options.optLevel == OptimizationLevel::O0) {
+		modulePassManager = passBuilder.buildO0DefaultPipeline(m_options.optLevel, m_options.lto != LTOMode::None);
+	} else if (m_options.lto == LTOMode::Full) {
+		modulePassManager = passBuilder.buildLTOPreLinkDefaultPipeline(m_options.optLevel);
+	} else if (m_options.lto == LTOMode::Thin) {
+		modulePassManager = passBuilder.buildThinLTOPreLinkDefaultPipeline(m_options.optLevel);
+	} else {
+		modulePassManager = passBuilder.buildPerModuleDefaultPipeline(m_options.optLevel);
+	}
+	modulePassManager.run(*module, moduleAnalysisManager);
+}
+
+bool Assembler::emitFile(const std::filesystem::path& filePath, Module* module, TargetMachine* targetMachine, CodeGenFileType fileType) {
+	TimeTraceScope scope(fileType == CodeGenFileType::AssemblyFile ? "Emit assembly" : "Emit object", filePath.string());
 
 	std::error_code errorCode;
-	raw_fd_ostream dest(objectFilePath.string(), errorCode, sys::fs::OF_None);
+	raw_fd_ostream dest(filePath.string(), errorCode, sys::fs::OF_None);
 
 	if (errorCode) {
-		llvm::errs() << "Could not open file: " << errorCode.message();
-		return;
+		errorOutput() << "Could not open file: " << errorCode.message() << "\n";
+		return false;
+	}
+
+	if (!emit(dest, module, targetMachine, fileType)) {
+		return false;
 	}
+	dest.flush();
+	return true;
+}
 
+bool Assembler::emit(raw_pwrite_stream& dest, Module* module, TargetMachine* targetMachine, CodeGenFileType fileType) {
 	legacy::PassManager pass;
 
-	if (TheTargetMachine->addPassesToEmitFile(pass, dest, nullptr, fileType)) {
-		llvm::errs() << "TheTargetMachine can't emit a file of this type";
-		return;
+	if (targetMachine->addPassesToEmitFile(pass, dest, nullptr, fileType)) {
+		errorOutput() << "TheTargetMachine can't emit a file of this type\n";
+		return false;
 	}
 
 	pass.run(*module);
-	dest.flush();
+	return true;
+}
 
-    #if !defined(NDEBUG)
-	if (fileType != CodeGenFileType::AssemblyFile) {
-		std::filesystem::path asmFilePath = objectFilePath.parent_path() / objectFilePath.stem();
-		asmFilePath += ".asm";
-		compileToObjectFile(asmFilePath, module, CodeGenFileType::AssemblyFile);
+void Assembler::emitBitcode(raw_ostream& dest, Module* module) const {
+	// NOTE: Linker doesn't know target cpu, so it's stored in every function, like clang does
+	std::string cpu, features;
+	getTargetCpuAndFeatures(&cpu, &features);
+	for (Function& function : *module) {
+		if (function.isDeclaration()) {
+			continue;
+		}
+		function.addFnAttr("target-cpu", cpu);
+		if (!features.empty()) {
+			function.addFnAttr("target-features", features);
+		}
 	}
-	#endif
+
+	if (m_options.lto == LTOMode::Thin) {
+		// NOTE: Summary of every call site asks profile summary, even if module has no profile
+		ProfileSummaryInfo profileSummary = ProfileSummaryInfo(*module);
+		ModuleSummaryIndex summaryIndex = buildModuleSummaryIndex(*module, nullptr, &profileSummary);
+		WriteBitcodeToFile(*module, dest, false, &summaryIndex);
+	} else {
+		WriteBitcodeToFile(*module, dest);
+	}
+	dest.flush();
+}
+
+CodeGenOptLevel Assembler::getCodeGenOptLevel(const OptimizationLevel& level) {
+	if (level == OptimizationLevel::O1) return CodeGenOptLevel::Less;
+	if (level == OptimizationLevel::O2) return CodeGenOptLevel::Default;
+	if (level == OptimizationLevel::O3) return CodeGenOptLevel::Aggressive;
+	return CodeGenOptLevel::None;
 }
 
 struct IncludedBinaryFile {
@@ -70,8 +370,74 @@ struct IncludedBinaryFile {
 };
 
 
-void Assembler::compileToExecutable(const std::filesystem::path& objectFilePath, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries) {
+bool Assembler::compileToExecutable(const std::filesystem::path& objectFilePath, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries) {
+	TimeTraceScope scope("Link", executableFilePath.string());
+
+	if (!link({ objectFilePath.string() }, executableFilePath, linkLibraries)) {
+		return false;
+	}
+
+	#ifdef NDEBUG
+	std::filesystem::remove(objectFilePath);
+	#endif
+	return true;
+}
+
+bool Assembler::compileToExecutable(const std::vector<ObjectBuffer>& objectBuffers, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries) {
+	TimeTraceScope scope("Link", executableFilePath.string());
+
+	std::vector<std::unique_ptr<MemoryFile>> objectFiles;
+	std::vector<std::string> objectFilePaths;
+	for (size_t i = 0; i < objectBuffers.size(); i++) {
+		std::string objectName = executableFilePath.stem().string() + "-" + std::to_string(i) + ".o";
+		auto objectFile = std::make_unique<MemoryFile>(objectName.c_str(), objectBuffers[i].data(), objectBuffers[i].size());
+		if (!objectFile->isValid()) {
+			break;
+		}
+		objectFilePaths.push_back(objectFile->getPath());
+		objectFiles.push_back(std::move(objectFile));
+	}
+	if (objectFiles.size() == objectBuffers.size()) {
+		return link(objectFilePaths, executableFilePath, linkLibraries);
+	}
+
+	// NOTE: No memory backed files on this platform, hand objects over through temporary files
+	std::vector<std::string> tmpFilePaths;
+	bool linked = true;
+	for (const auto& objectBuffer : objectBuffers) {
+		int fileDescriptor;
+		SmallString<128> tmpFilePath;
+		if (std::error_code error = sys::fs::createTemporaryFile(executableFilePath.stem().string(), "o", fileDescriptor, tmpFilePath)) {
+			errorOutput() << "Could not create temporary object file: " << error.message() << "\n";
+			linked = false;
+			break;
+		}
+		raw_fd_ostream tmpFile(fileDescriptor, true);
+		tmpFile.write(objectBuffer.data(), objectBuffer.size());
+		tmpFilePaths.push_back(tmpFilePath.str().str());
+	}
+	if (linked) {
+		linked = link(tmpFilePaths, executableFilePath, linkLibraries);
+	}
+	for (const auto& tmpFilePath : tmpFilePaths) {
+		sys::fs::remove(tmpFilePath);
+	}
+	return linked;
+}
+
+bool Assembler::compileToExecutable(const std::vector<std::filesystem::path>& objectFilePaths, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries) {
+	TimeTraceScope scope("Link", executableFilePath.string());
+
+	std::vector<std::string> objects;
+	for (const auto& objectFilePath : objectFilePaths) {
+		objects.push_back(objectFilePath.string());
+	}
+	return link(objects, executableFilePath, linkLibraries);
+}
+
+bool Assembler::link(const std::vector<std::string>& objectFilePaths, const std::filesystem::path& executableFilePath, std::vector<std::filesystem::path>& linkLibraries) {
 	lld::Result result;
+	std::vector<std::unique_ptr<MemoryFile>> memoryFiles; // must outlive lld call
 	std::vector<std::string> args;
 	lld::DriverDef drivers[1] = {};
 
@@ -86,13 +452,16 @@ void Assembler::compileToExecutable(const std::filesystem::path& objectFilePath,
 		};
 
 		args.push_back("ld");
-		args.push_back(objectFilePath.string());
+		args.insert(args.end(), objectFilePaths.begin(), objectFilePaths.end());
 		args.push_back("-o");
 		args.push_back(executableFilePath.string());
 
 		for (const auto& file : INCLUDED_FILES) {
-			auto path = storeFileTmp(file.name, file.compressedData, file.compressedSize, file.originalSize);
-			args.push_back(path.string());
+			std::string filePath = extractRuntimeFile(file.name, file.compressedData, file.compressedSize, file.originalSize, &memoryFiles);
+			if (filePath.empty()) {
+				return false;
+			}
+			args.push_back(std::move(filePath));
 		}
 
 		drivers[0] = {lld::MinGW, &lld::mingw::link};
@@ -107,13 +476,27 @@ void Assembler::compileToExecutable(const std::filesystem::path& objectFilePath,
 		};
 
 		args.push_back("ld.lld");
-		args.push_back(objectFilePath);
+		args.insert(args.end(), objectFilePaths.begin(), objectFilePaths.end());
 		args.push_back("-o");
-		args.push_back(executableFilePath);
+		args.push_back(executableFilePath.string());
 
 		for (const auto& file : INCLUDED_FILES) {
-			auto path = storeFileTmp(file.name, file.compressedData, file.compressedSize, file.originalSize);
-			args.push_back(path.string());
+			std::string filePath = extractRuntimeFile(file.name, file.compressedData, file.compressedSize, file.originalSize, &memoryFiles);
+			if (filePath.empty()) {
+				return false;
+			}
+			args.push_back(std::move(filePath));
+		}
+
+		if (m_options.lto != LTOMode::None) {
+			const std::string optLevel = std::to_string(m_options.optLevel.getSpeedupLevel());
+			args.push_back("--lto-O" + optLevel);
+			args.push_back("--lto-CGO" + optLevel);
+			if (m_options.lto == LTOMode::Full) {
+				args.push_back("--lto-partitions=" + std::to_string(m_options.codegenThreads));
+			} else {
+				args.push_back("--thinlto-jobs=" + std::to_string(m_options.codegenThreads));
+			}
 		}
 
 		drivers[0] = {lld::Gnu, &lld::elf::link};
@@ -130,51 +513,159 @@ void Assembler::compileToExecutable(const std::filesystem::path& objectFilePath,
 		argsCstr[i] = args[i].c_str();
 	}
 
-	result = lld::lldMain(argsCstr, llvm::outs(), llvm::errs(), drivers);
-
+	{
+		std::lock_guard<std::mutex> lock(s_linkerMutex);
+		if (!s_canLinkAgain) {
+			errorOutput() << "Error: Linker can't run again in this process\n";
+			return false;
+		}
+		TimeTraceScope lldScope("lld");
+		raw_os_ostream lldOutput(ErrorHandler::getLogOutput());
+		raw_os_ostream lldErrors(ErrorHandler::getOutput());
+		result = lld::lldMain(argsCstr, lldOutput, lldErrors, drivers);
+		s_canLinkAgain = result.canRunAgain;
+	}
 
 	if (result.retCode != 0) {
-		llvm::errs() << "Error: Linking failed with return code " << result.retCode << "\n";
-		return;
+		errorOutput() << "Error: Linking failed with return code " << result.retCode << "\n";
+		return false;
 	}
 
+	// NOTE: Process isn't exited (lld::exitLld), compile server has to answer it's client and keep running
 	if (!result.canRunAgain) {
-		llvm::errs() << "Error: Linker cannot run again, exiting...\n"; 
-		llvm::errs().flush();
-		lld::exitLld(result.retCode);
-		return;
+		errorOutput() << "Error: Linker cannot run again\n";
+		return false;
 	}
 
-	llvm::outs().flush();
-	llvm::errs().flush();
-
-	#ifdef NDEBUG
-	std::filesystem::remove(objectFilePath);
-	#else
-	std::cout << "Linked successfully!" << std::endl;
+	#ifndef NDEBUG
+	ErrorHandler::getLogOutput() << "Linked successfully!" << std::endl;
 	#endif
+	return true;
 }
 
-std::filesystem::path Assembler::storeFileTmp(const char* name, const unsigned char* compressedData, size_t compressedSize, size_t originalSize) {
-    const auto pathForFile = std::filesystem::temp_directory_path() / "lsc" / name;
-    if (std::filesystem::exists(pathForFile)) {
-        // NOTE: It might be a better idea to calculate checksum of this file and use it, if it's OK
-        //       But for now I link small libraries and don't care about performance as much.
-        std::filesystem::remove(pathForFile);
-    }
-
-    std::filesystem::create_directories(pathForFile.parent_path());
+std::string Assembler::extractRuntimeFile(const char* name, const unsigned char* compressedData, size_t compressedSize, size_t originalSize, std::vector<std::unique_ptr<MemoryFile>>* memoryFiles) const {
+	if (m_options.inMemory) {
+		TimeTraceScope scope("Extract library", name);
 
-    std::ofstream tmpFile;
-    tmpFile.open(pathForFile, std::ios::binary);
+		std::vector<char> decompressedData = decompress(compressedData, compressedSize, originalSize);
+		auto memoryFile = std::make_unique<MemoryFile>(name, decompressedData.data(), originalSize);
+		if (memoryFile->isValid()) {
+			std::string path = memoryFile->getPath();
+			memoryFiles->push_back(std::move(memoryFile));
+			return path;
+		}
+	}
+	return storeFileTmp(name, compressedData, compressedSize, originalSize).string();
+}
 
-	std::vector<char> data = std::vector<char>(compressedData, compressedData+ compressedSize);
+std::vector<char> Assembler::decompress(const unsigned char* compressedData, size_t compressedSize, size_t originalSize) {
 	std::vector<char> decompressedData(originalSize);
-    int decompressedSize = fastlz_decompress(data.data(), data.size(), decompressedData.data(), originalSize);
+    int decompressedSize = fastlz_decompress(compressedData, compressedSize, decompressedData.data(), originalSize);
     assert(decompressedSize > 0 && "Decompression failed");
+    (void)decompressedSize;
+	return decompressedData;
+}
+
+std::filesystem::path Assembler::storeFileTmp(const char* name, const unsigned char* compressedData, size_t compressedSize, size_t originalSize) {
+    TimeTraceScope scope("Extract library", name);
+
+    // Cache is content addressed: file name contains hash of the embedded data, 
+    // so warm builds reuse extracted file and files of other compiler versions never collide.
+    // NOTE: Temp directory is shared with other users, so every user gets own private directory
+    const uint64_t hash = xxh3_64bits(ArrayRef<uint8_t>(compressedData, compressedSize));
+    #if defined(__linux__)
+        const auto userDir = std::filesystem::temp_directory_path() / ("lsc-" + std::to_string(getuid()));
+    #else
+        const auto userDir = std::filesystem::temp_directory_path() / "lsc";
+    #endif
+    const auto cacheDir = userDir / (std::string("v") + LSC_VERSION);
+    const auto pathForFile = cacheDir / (utohexstr(hash, true) + "-" + name);
+
+    if (std::error_code error = sys::fs::create_directories(cacheDir.string(), true, sys::fs::perms::owner_all)) {
+        errorOutput() << "Could not create directory " << cacheDir.string() << ": " << error.message() << "\n";
+        return {};
+    }
+    #if defined(__linux__)
+        struct stat userDirStat;
+        if (lstat(userDir.c_str(), &userDirStat) != 0 || !S_ISDIR(userDirStat.st_mode) 
+            || userDirStat.st_uid != getuid() || (userDirStat.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+            errorOutput() << "Directory " << userDir.string() << " isn't a private directory of this user, runtime libraries aren't extracted to it\n";
+            return {};
+        }
+    #endif
+
+	std::vector<char> decompressedData = decompress(compressedData, compressedSize, originalSize);
+    const StringRef content = StringRef(decompressedData.data(), originalSize);
+
+    // File of previous build is used only if it's unchanged (e.g. not cut by full disk)
+    if (auto existingFile = MemoryBuffer::getFile(pathForFile.string(), false, false)) {
+        if ((*existingFile)->getBuffer() == content) {
+            return pathForFile;
+        }
+    }
 
-    tmpFile.write(reinterpret_cast<const char*>(decompressedData.data()), originalSize);
-    tmpFile.flush();
-    tmpFile.close();
+    // Write to unique temporary file and rename it into place, 
+    // so parallel lsc processes never see or link half written file
+    int fileDescriptor;
+    SmallString<128> tmpFilePath;
+    if (std::error_code error = sys::fs::createUniqueFile(pathForFile.string() + "-%%%%%%%%.tmp", fileDescriptor, tmpFilePath)) {
+        errorOutput() << "Could not create file in " << cacheDir.string() << ": " << error.message() << "\n";
+        return {};
+    }
+    {
+        raw_fd_ostream tmpFile(fileDescriptor, true);
+        tmpFile << content;
+        tmpFile.close();
+        if (tmpFile.has_error()) {
+            errorOutput() << "Could not write " << tmpFilePath << ": " << tmpFile.error().message() << "\n";
+            tmpFile.clear_error();
+            sys::fs::remove(tmpFilePath);
+            return {};
+        }
+    }
+    if (sys::fs::rename(tmpFilePath, pathForFile.string())) {
+        // Other process was faster (on windows file can't be replaced, while linker is reading it)
+        sys::fs::remove(tmpFilePath);
+    }
     return pathForFile;
 }
+
+MemoryFile::MemoryFile(const char* name, const char* data, size_t size)
+	: m_fileDescriptor(-1) {
+	#if defined(__linux__)
+	int fileDescriptor = memfd_create(name, MFD_CLOEXEC);
+	if (fileDescriptor < 0) {
+		return;
+	}
+
+	size_t written = 0;
+	while (written < size) {
+		ssize_t count = ::write(fileDescriptor, data + written, size - written);
+		if (count < 0) {
+			if (errno == EINTR) continue;
+			::close(fileDescriptor);
+			return;
+		}
+		written += count;
+	}
+	m_fileDescriptor = fileDescriptor;
+	#else
+	(void)name; (void)data; (void)size;
+	#endif
+}
+
+MemoryFile::~MemoryFile() {
+	#if defined(__linux__)
+	if (m_fileDescriptor >= 0) {
+		::close(m_fileDescriptor);
+	}
+	#endif
+}
+
+bool MemoryFile::isValid() const {
+	return m_fileDescriptor >= 0;
+}
+
+std::string MemoryFile::getPath() const {
+	return "/proc/self/fd/" + std::to_string(m_fileDescriptor);
+}
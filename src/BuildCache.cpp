@@ -0,0 +1,90 @@
+#include "BuildCache.hpp"
+
+BuildCache::BuildCache(const std::filesystem::path& cacheDir, uint64_t maxSizeBytes)
+    : m_cacheDir(cacheDir)
+    , m_maxSizeBytes(maxSizeBytes) {}
+
+// NOTE: Every part is prefixed with it's size, so different inputs can't produce same byte stream
+static void hashPart(BLAKE3* hasher, StringRef part) {
+    const uint64_t size = part.size();
+    hasher->update(ArrayRef<uint8_t>((const uint8_t*)&size, sizeof(size)));
+    hasher->update(part);
+}
+
+std::string BuildCache::computeKey(const std::u8string& mergedSourceCode, const std::vector<std::filesystem::path>& linkLibraries, const CodeGenOptions& options) {
+    TimeTraceScope scope("Compute cache key");
+
+    BLAKE3 hasher;
+    hashPart(&hasher, getCompilerIdentity());
+    hashPart(&hasher, StringRef((const char*)mergedSourceCode.data(), mergedSourceCode.size()));
+
+    for (const auto& library : linkLibraries) {
+        std::error_code errorCode;
+        auto size = std::filesystem::file_size(library, errorCode);
+        auto lastWriteTime = std::filesystem::last_write_time(library, errorCode).time_since_epoch().count();
+        hashPart(&hasher, library.string());
+        hashPart(&hasher, std::to_string(size) + ":" + std::to_string(lastWriteTime));
+    }
+
+    hashPart(&hasher, sys::getDefaultTargetTriple());
+    hashPart(&hasher, std::to_string(options.optLevel.getSpeedupLevel()) + ":" + std::to_string(options.optLevel.getSizeLevel()));
+    hashPart(&hasher, options.targetCpu == "native" ? sys::getHostCPUName() : StringRef(options.targetCpu));
+    hashPart(&hasher, std::to_string(options.relocModel) + ":" + std::to_string(options.codeModel));
+    hashPart(&hasher, std::to_string(static_cast<int>(options.lto)));
+
+    return toHex(hasher.final(), true);
+}
+
+bool BuildCache::fetch(const std::string& key, const std::filesystem::path& executableFilePath) const {
+    TimeTraceScope scope("Fetch from cache", key);
+
+    const auto entryPath = getEntryPath(key);
+    std::error_code errorCode;
+    std::filesystem::copy_file(entryPath, executableFilePath, std::filesystem::copy_options::overwrite_existing, errorCode);
+    if (errorCode) {
+        return false;
+    }
+
+    // Entry was used now, so it's evicted last (file systems mounted with noatime don't update it on read)
+    int fileDescriptor;
+    if (!sys::fs::openFileForRead(entryPath.string(), fileDescriptor)) {
+        auto now = std::chrono::system_clock::now();
+        sys::fs::setLastAccessAndModificationTime(fileDescriptor, now, now);
+        sys::Process::SafelyCloseFileDescriptor(fileDescriptor);
+    }
+    return true;
+}
+
+void BuildCache::store(const std::string& key, const std::filesystem::path& executableFilePath) const {
+    TimeTraceScope scope("Store in cache", key);
+
+    std::error_code errorCode;
+    std::filesystem::create_directories(m_cacheDir, errorCode);
+
+    // Copy to unique temporary file and rename it into place, so parallel builds never see half written entry.
+    // NOTE: Temporary file mustn't have "llvmcache-" prefix, otherwise concurrent prune could evict it while it's written
+    const auto entryPath = getEntryPath(key);
+    int fileDescriptor;
+    SmallString<128> tmpFilePath;
+    if (sys::fs::createUniqueFile((m_cacheDir / ("tmp-" + key + "-%%%%%%%%")).string(), fileDescriptor, tmpFilePath)) {
+        return;
+    }
+    sys::Process::SafelyCloseFileDescriptor(fileDescriptor);
+    std::filesystem::copy_file(executableFilePath, tmpFilePath.str().str(), std::filesystem::copy_options::overwrite_existing, errorCode);
+    if (errorCode || sys::fs::rename(tmpFilePath, entryPath.string())) {
+        sys::fs::remove(tmpFilePath);
+        return;
+    }
+
+    CachePruningPolicy policy;
+    policy.Interval = std::chrono::seconds(0); // prune on every store
+    policy.Expiration = std::chrono::seconds(0); // only size limit evicts entries
+    policy.MaxSizeBytes = m_maxSizeBytes;
+    policy.MaxSizePercentageOfAvailableSpace = 100;
+    pruneCache(m_cacheDir.string(), policy);
+}
+
+std::filesystem::path BuildCache::getEntryPath(const std::string& key) const {
+    // NOTE: pruneCache only considers files with "llvmcache-" prefix
+    return m_cacheDir / ("llvmcache-" + key);
+}
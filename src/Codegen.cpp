@@ -1,6 +1,8 @@
 #include "AST.hpp"
 #include "IRContext.hpp"
 #include "ErrorHandler.hpp"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/raw_os_ostream.h"
 
 llvm::Value* BlockAST::codegen(IRContext& context) {
     context.symbolTable.enterScope();
@@ -16,8 +18,8 @@ const char* cStr(const std::u8string& str) {
 }
 
 llvm::Value* NumberAST::codegen(IRContext& context) {
-    // signed 32bit integer
-    return llvm::ConstantInt::get(*context.context, llvm::APInt(32, m_value, true));
+    // signed 32bit integer, 64bit if it doesn't fit
+    return llvm::ConstantInt::get(*context.context, llvm::APInt(isLong() ? 64 : 32, m_value, true));
 }
 
 llvm::Value* CharAST::codegen(IRContext& context) {
@@ -78,7 +80,7 @@ llvm::Value* ArrayAST::codegen(IRContext& context) {
     llvm::AllocaInst* arrayVariable = tmpBuilder.CreateAlloca(arrayType, nullptr, "tmpArr");
     int i = 0;
     for (const auto& val : values) {
-        static llvm::Value* zero = llvm::ConstantInt::get(*context.context, llvm::APInt(32, 0, true));
+        llvm::Value* zero = llvm::ConstantInt::get(*context.context, llvm::APInt(32, 0, true));
         llvm::Value* index = llvm::ConstantInt::get(*context.context, llvm::APInt(32, i, true));
         llvm::Value* gep = context.builder->CreateInBoundsGEP(type, arrayVariable, {zero, index}, "arrIdx");
         context.builder->CreateStore(val, gep);
@@ -99,6 +101,15 @@ llvm::Value* VariableDeclarationAST::codegen(IRContext& context) {
         context.symbolTable.addVariable(m_name, m_type.get(), stackVariable);
         return stackVariable;
     }
+    // global of other module
+    if (context.declarationsOnly) {
+        llvm::GlobalVariable* globalVariable = new llvm::GlobalVariable(
+            *context.theModule, type, false, llvm::GlobalValue::ExternalLinkage, nullptr, cStr(m_name)
+        );
+        context.symbolTable.addGlobal(m_name, m_type.get(), globalVariable);
+        return globalVariable;
+    }
+
     // global
     llvm::GlobalVariable* globalVariable = new llvm::GlobalVariable(
         *context.theModule, 
@@ -198,7 +209,18 @@ llvm::Value* BinaryOperatorAST::codegen(IRContext& context) {
     if (left->getType()->isPointerTy())
         left = context.builder->CreateLoad(m_LHS->getType(context)->getLLVMType(*context.context), left, "loadtmp");
     if (right->getType()->isPointerTy())
-        right = context.builder->CreateLoad(m_LHS->getType(context)->getLLVMType(*context.context), right, "loadtmp");
+        right = context.builder->CreateLoad(m_RHS->getType(context)->getLLVMType(*context.context), right, "loadtmp");
+
+    // numerus is promoted to magnus, if other side is magnus
+    llvm::Type* leftType = left->getType();
+    llvm::Type* rightType = right->getType();
+    if (leftType != rightType && leftType->isIntegerTy() && rightType->isIntegerTy()
+        && leftType->getIntegerBitWidth() >= 32 && rightType->getIntegerBitWidth() >= 32) {
+        if (leftType->getIntegerBitWidth() < rightType->getIntegerBitWidth())
+            left = context.builder->CreateSExt(left, rightType, "conv");
+        else
+            right = context.builder->CreateSExt(right, leftType, "conv");
+    }
 
     if (m_op == operators::EQUAL) {
         return context.builder->CreateICmpEQ(left, right, "eqtmp");
@@ -253,16 +275,27 @@ llvm::Value* FuncCallAST::codegen(IRContext& context) {
     }
 
     if (function->arg_size() != (m_args.size() + (!isExtern && hasReturn ? 1 : 0))) {
-        std::cout << cStr(m_calleeIdentifier) << std::endl;
+        ErrorHandler::getLogOutput() << cStr(m_calleeIdentifier) << std::endl;
         return nullptr;
     }
 
     std::vector<llvm::Value*> arguments;
     arguments.reserve(function->arg_size());
-    for (auto& arg : m_args) {
+    for (size_t i = 0; i < m_args.size(); i++) {
+        const auto& arg = m_args[i];
         llvm::Value* argValue = arg->codegen(context);
         if (!argValue)
             return nullptr;
+
+        // Callee reads argument with width of it's parameter, so integers are sign-extended or truncated to it
+        llvm::Type* argType = arg->getType(context)->getLLVMType(*context.context);
+        llvm::Type* paramType = i < entry->argTypes.size() ? entry->argTypes[i]->getLLVMType(*context.context) : argType;
+        if (argType != paramType && argType->isIntegerTy() && paramType->isIntegerTy()) {
+            if (argValue->getType()->isPointerTy())
+                argValue = context.builder->CreateLoad(argType, argValue, "loadtmp");
+            argValue = context.builder->CreateIntCast(argValue, paramType, true, "conv");
+            argType = paramType;
+        }
         
         // functions arguments are always pointers, not value. => Create local variables if needed
         if (!argValue->getType()->isPointerTy()) {
@@ -273,7 +306,6 @@ llvm::Value* FuncCallAST::codegen(IRContext& context) {
             }
             llvm::BasicBlock* insertBlock = &(currentBlock->getParent()->getEntryBlock());
             llvm::IRBuilder<> tmpBuilder(insertBlock, insertBlock->begin());
-            llvm::Type* argType = arg->getType(context)->getLLVMType(*context.context);
             llvm::AllocaInst* stackVariable = tmpBuilder.CreateAlloca(argType, nullptr, "argTmp");
             context.builder->CreateStore(argValue, stackVariable);
             argValue = stackVariable;
@@ -320,10 +352,13 @@ llvm::Value* FuncCallAST::codegen(IRContext& context) {
 
 llvm::Value* FunctionPrototypeAST::codegen(IRContext& context) {
     std::vector<llvm::Type*> argTypes;
+    std::vector<const IDataType*> argDataTypes;
     argTypes.reserve(m_args.size() + 1);
+    argDataTypes.reserve(m_args.size());
     for (const auto& arg : m_args) {
         llvm::Type* type = arg->type->getLLVMType(*context.context);
         argTypes.push_back(llvm::PointerType::get(type, 0));
+        argDataTypes.push_back(arg->type.get());
     }
 
     // NOTE(Vlad): can lead to problems, because main and extern defined functions, should not have "return arguments"
@@ -335,7 +370,12 @@ llvm::Value* FunctionPrototypeAST::codegen(IRContext& context) {
     }
     
     llvm::FunctionType* funcType = llvm::FunctionType::get(returnType, argTypes, false);
-    llvm::Function* function = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, cStr(m_name), *context.theModule);
+
+    // NOTE: Same prototype can be declared by several modules, reuse declaration instead of creating renamed copy
+    llvm::Function* function = context.theModule->getFunction(cStr(m_name));
+    if (!function || function->getFunctionType() != funcType) {
+        function = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, cStr(m_name), *context.theModule);
+    }
 
     for (size_t i = 0; i < m_args.size(); i++) {
         function->getArg(i)->setName(cStr(m_args[i]->identifier));
@@ -344,11 +384,16 @@ llvm::Value* FunctionPrototypeAST::codegen(IRContext& context) {
         function->getArg(function->arg_size()-1)->setName(RETURN_ARG_NAME);
     }
 
-    context.symbolTable.addFunction(m_name, m_returnType.get(), function);
+    context.symbolTable.addFunction(m_name, m_returnType.get(), function, argDataTypes);
     return function;
 }
 
 llvm::Value* FunctionAST::codegen(IRContext& context) {
+    if (context.declarationsOnly) {
+        return m_prototype->codegen(context); // defined in object of other module
+    }
+
+    llvm::TimeTraceScope scope("Codegen function", cStr(m_prototype->getName()));
     llvm::Function* function = dyn_cast<llvm::Function>(m_prototype->codegen(context));
     if (!function->empty()){ // it's a redifinition
         ErrorHandler::logError(u8"Syntax Error: Function " + m_prototype->getName() + u8" is already defined!", m_line);
@@ -373,7 +418,8 @@ llvm::Value* FunctionAST::codegen(IRContext& context) {
     if (!context.builder->GetInsertBlock()->getTerminator())
         context.builder->CreateRetVoid(); 
 
-    if (llvm::verifyFunction(*function, &(llvm::errs()))) {
+    llvm::raw_os_ostream verifierOutput(ErrorHandler::getOutput());
+    if (llvm::verifyFunction(*function, &verifierOutput)) {
         ErrorHandler::logError(u8"Syntax Error: Content of function " + m_prototype->getName() +  u8" is not valid!", m_line);
         function->eraseFromParent();
         return nullptr;
@@ -402,7 +448,13 @@ llvm::Value* ReturnAST::codegen(IRContext& context) {
     }
 
     llvm::Function* function = currentBlock->getParent();
-    if (function->getName() == "main") // main needs a value return
+    const std::string functionName = function->getName().str();
+    const ScopeEntry* entry = context.symbolTable.lookupFunction(std::u8string(functionName.begin(), functionName.end()));
+    llvm::Type* returnType = entry ? entry->type->getLLVMType(*context.context) : value->getType();
+    if (value->getType() != returnType && value->getType()->isIntegerTy() && returnType->isIntegerTy())
+        value = context.builder->CreateIntCast(value, returnType, true, "conv");
+
+    if (functionName == "main") // main needs a value return
         return context.builder->CreateRet(value);
 
     llvm::Argument* returnArg = function->getArg(function->arg_size()-1);
@@ -493,7 +545,7 @@ llvm::Value* AccessArrayElementAST::codegen(IRContext &context) {
         if (index->getType()->isPointerTy())
             index = context.builder->CreateLoad(llvm::Type::getInt32Ty(*context.context), index, "loadtmp");
     
-        static llvm::Value* zero = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context.context), llvm::APInt(32, 0, true));
+        llvm::Value* zero = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context.context), llvm::APInt(32, 0, true));
         return context.builder->CreateInBoundsGEP(type, arrVar->value, {zero, index}, "arrIdx");
     }
     const StructDataType* structType = dynamic_cast<const StructDataType*>(arrVar->type);
@@ -520,12 +572,12 @@ llvm::Value* AccessArrayElementAST::codegen(IRContext &context) {
                 return nullptr;
             }
         } else if (number) {
-            index = number->getValue();
-            if (index >= (int)iter->attributes.size() || index < 0) {
-                std::string indexStr = std::to_string(index);
+            if (number->getValue() >= (int64_t)iter->attributes.size() || number->getValue() < 0) {
+                std::string indexStr = std::to_string(number->getValue());
                 ErrorHandler::logError(u8"Syntax Error: Can't find " + std::u8string(indexStr.begin(), indexStr.end()) + u8" attribute in '" + m_name + u8"' struct!", m_line);
                 return nullptr;
             }
+            index = (int)number->getValue();
         } else {
             ErrorHandler::logError(u8"Syntax Error: Wrong syntax accessing struct attribute!", m_line);
             return nullptr;
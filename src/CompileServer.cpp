@@ -0,0 +1,280 @@
+#include "CompileServer.hpp"
+
+// Protocol (one request per connection):
+//   client -> server: uint32 payload size + stdout and stderr as SCM_RIGHTS, 
+//                     payload: working directory and arguments, each terminated by '\0'
+//   server -> client: int32 exit code
+
+#if !defined(_WIN32)
+
+int CompileServer::serve(const std::string& socketPath) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is too long " << socketPath << std::endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+
+    // NOTE: Only socket of previous server is removed, never other file that happens to be at path
+    struct stat fileStatus;
+    if (lstat(socketPath.c_str(), &fileStatus) == 0) {
+        if (!S_ISSOCK(fileStatus.st_mode)) {
+            std::cerr << "Error: " << socketPath << " already exists and isn't a socket" << std::endl;
+            return 1;
+        }
+        unlink(socketPath.c_str());
+    }
+
+    // Socket is created with mode 0600: clients make server compile and run code as it's user, so only that user may connect
+    int serverSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const mode_t previousMask = umask(0177);
+    const bool isBound = serverSocket >= 0 && bind(serverSocket, (sockaddr*)&address, sizeof(address)) == 0;
+    umask(previousMask);
+    if (!isBound || listen(serverSocket, 64) != 0) {
+        std::cerr << "Error: Couldn't listen on " << socketPath << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // NOTE: Client can go away while we are writing to it's stdout, that must not kill server
+    signal(SIGPIPE, SIG_IGN);
+
+    Assembler::initializeTargets();
+    Preprocessor::enableFileCache(true);
+
+    std::cout << "LSC " << LSC_VERSION << " compile server is listening on " << socketPath << std::endl;
+    while (true) {
+        int clientSocket = accept4(serverSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientSocket < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: accept failed: " << strerror(errno) << std::endl;
+            continue;
+        }
+        handleClient(clientSocket);
+        close(clientSocket);
+        if (!Assembler::canLinkAgain()) {
+            std::cerr << "Warning: Linker can't run again, restart the compile server to link executables" << std::endl;
+        }
+    }
+}
+
+void CompileServer::handleClient(int clientSocket) {
+    uint32_t payloadSize = 0;
+    int clientFds[2] = { -1, -1 }; // stdout, stderr
+
+    iovec sizeVector = { &payloadSize, sizeof(payloadSize) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(clientFds))];
+    msghdr message = {};
+    message.msg_iov = &sizeVector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    const ssize_t receivedSize = recvmsg(clientSocket, &message, MSG_CMSG_CLOEXEC);
+
+    // NOTE: Kernel installs every descriptor that was sent, so descriptors of invalid request have to be closed
+    std::vector<int> receivedFds;
+    if (receivedSize >= 0) {
+        for (cmsghdr* controlHeader = CMSG_FIRSTHDR(&message); controlHeader; controlHeader = CMSG_NXTHDR(&message, controlHeader)) {
+            if (controlHeader->cmsg_level != SOL_SOCKET || controlHeader->cmsg_type != SCM_RIGHTS) {
+                continue;
+            }
+            const size_t fdCount = (controlHeader->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            for (size_t i = 0; i < fdCount; i++) {
+                int fd;
+                memcpy(&fd, CMSG_DATA(controlHeader) + i * sizeof(int), sizeof(int));
+                receivedFds.push_back(fd);
+            }
+        }
+    }
+    const bool isValidRequest = receivedSize == sizeof(payloadSize) && !(message.msg_flags & MSG_CTRUNC) 
+        && receivedFds.size() == 2 && payloadSize <= MAX_PAYLOAD_SIZE;
+    if (!isValidRequest) {
+        if (payloadSize > MAX_PAYLOAD_SIZE) {
+            std::cerr << "Error: Request of " << payloadSize << " bytes is too large, it's rejected" << std::endl;
+        }
+        for (int fd : receivedFds) {
+            close(fd);
+        }
+        return;
+    }
+    clientFds[0] = receivedFds[0];
+    clientFds[1] = receivedFds[1];
+
+    std::string payload(payloadSize, '\0');
+    if (!readAll(clientSocket, payload.data(), payloadSize)) {
+        close(clientFds[0]);
+        close(clientFds[1]);
+        return;
+    }
+
+    // payload = cwd\0arg1\0arg2\0...
+    std::vector<const char*> argv = { "lsc" };
+    const char* workingDirectory = payload.c_str();
+    for (size_t i = strlen(workingDirectory) + 1; i < payload.size(); i += strlen(payload.c_str() + i) + 1) {
+        argv.push_back(payload.c_str() + i);
+    }
+
+    // Compile with output going to client
+    std::cout.flush();
+    std::cerr.flush();
+    int serverStdout = dup(STDOUT_FILENO);
+    int serverStderr = dup(STDERR_FILENO);
+    dup2(clientFds[0], STDOUT_FILENO);
+    dup2(clientFds[1], STDERR_FILENO);
+    close(clientFds[0]);
+    close(clientFds[1]);
+
+    int32_t exitCode = 1;
+    std::error_code errorCode;
+    const auto serverDirectory = std::filesystem::current_path();
+    std::filesystem::current_path(workingDirectory, errorCode);
+    if (errorCode) {
+        std::cerr << "Error: Server can't enter directory " << workingDirectory << std::endl;
+    } else {
+        CompilerOptions options;
+        if (Driver::parseArguments(argv.size(), argv.data(), &options)) {
+            if (!options.serverSocket.empty()) {
+                std::cerr << "Error: --server can't be requested from client" << std::endl;
+            } else if (options.runInJit) {
+                exitCode = runInChildProcess(options);
+            } else {
+                exitCode = Driver::run(options);
+            }
+        }
+    }
+    std::filesystem::current_path(serverDirectory, errorCode);
+
+    std::cout.flush();
+    std::cerr.flush();
+    llvm::outs().flush();
+    llvm::errs().flush();
+    dup2(serverStdout, STDOUT_FILENO);
+    dup2(serverStderr, STDERR_FILENO);
+    close(serverStdout);
+    close(serverStderr);
+
+    writeAll(clientSocket, (const char*)&exitCode, sizeof(exitCode));
+}
+
+int CompileServer::runInChildProcess(const CompilerOptions& options) {
+    // NOTE: Program can call exit or crash, that must end only the child process and not the server
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t child = fork();
+    if (child < 0) {
+        std::cerr << "Error: Couldn't start process for --run: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    if (child == 0) {
+        int exitCode = Driver::run(options);
+        std::cout.flush();
+        std::cerr.flush();
+        llvm::outs().flush();
+        llvm::errs().flush();
+        _exit(exitCode);
+    }
+
+    int status;
+    while (waitpid(child, &status, 0) < 0) {
+        if (errno != EINTR) {
+            std::cerr << "Error: Lost process of --run: " << strerror(errno) << std::endl;
+            return 1;
+        }
+    }
+    if (WIFSIGNALED(status)) {
+        std::cerr << "Error: Program was terminated by signal " << WTERMSIG(status) << std::endl;
+        return 128 + WTERMSIG(status);
+    }
+    return WEXITSTATUS(status);
+}
+
+int CompileServer::connect(const std::string& socketPath, const std::vector<std::string>& args) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is too long " << socketPath << std::endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+
+    int serverSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (serverSocket < 0 || ::connect(serverSocket, (sockaddr*)&address, sizeof(address)) != 0) {
+        std::cerr << "Error: Couldn't connect to compile server " << socketPath << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::string payload = std::filesystem::current_path().string();
+    payload += '\0';
+    for (const auto& arg : args) {
+        payload += arg;
+        payload += '\0';
+    }
+    if (payload.size() > MAX_PAYLOAD_SIZE) {
+        std::cerr << "Error: Arguments are too long for compile server" << std::endl;
+        close(serverSocket);
+        return 1;
+    }
+
+    uint32_t payloadSize = payload.size();
+    int fds[2] = { STDOUT_FILENO, STDERR_FILENO };
+    iovec sizeVector = { &payloadSize, sizeof(payloadSize) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+    msghdr message = {};
+    message.msg_iov = &sizeVector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* controlHeader = CMSG_FIRSTHDR(&message);
+    controlHeader->cmsg_level = SOL_SOCKET;
+    controlHeader->cmsg_type = SCM_RIGHTS;
+    controlHeader->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(controlHeader), fds, sizeof(fds));
+
+    int32_t exitCode = 1;
+    if (sendmsg(serverSocket, &message, 0) != sizeof(payloadSize) 
+        || !writeAll(serverSocket, payload.data(), payload.size()) 
+        || !readAll(serverSocket, (char*)&exitCode, sizeof(exitCode))) {
+        std::cerr << "Error: Lost connection to compile server " << socketPath << std::endl;
+        exitCode = 1;
+    }
+    close(serverSocket);
+    return exitCode;
+}
+
+bool CompileServer::writeAll(int fileDescriptor, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t count = write(fileDescriptor, data, size);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+bool CompileServer::readAll(int fileDescriptor, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t count = read(fileDescriptor, data, size);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+#else
+
+int CompileServer::serve([[maybe_unused]] const std::string& socketPath) {
+    std::cerr << "Error: Compile server isn't supported on windows" << std::endl;
+    return 1;
+}
+
+int CompileServer::connect([[maybe_unused]] const std::string& socketPath, [[maybe_unused]] const std::vector<std::string>& args) {
+    std::cerr << "Error: Compile server isn't supported on windows" << std::endl;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,456 @@
+#include "Driver.hpp"
+
+void Driver::printHelp(std::ostream& ostr) {
+    ostr << "Usage: \n"
+        <<"\t"<<"lsc <input_file.lorem>... [options]"<<" "<<"compiles each file to executable\n"
+        <<"\t"<<"lsc [options] --run <input_file.lorem> [args]"<<" "<<"compiles file in memory and runs it with args\n"
+        <<"\t"<<"lsc --server <socket>"<<" "<<"starts compile server, that stays resident and compiles requests of clients\n"
+        <<"\t"<<"lsc --connect <socket> <input_file.lorem> [options]"<<" "<<"lets compile server do the compilation\n"
+        << "Options: \n"
+        <<"\t"<<"-O0, -O1, -O2, -O3"<<"               "<<"optimization level (default: -O0)\n"
+        <<"\t"<<"--target-cpu=<name|native>"<<"       "<<"generate code for cpu (default: generic), alias: -march=\n"
+        <<"\t"<<"--reloc=<pic|static>"<<"             "<<"relocation model (default: pic)\n"
+        <<"\t"<<"--code-model=<small|medium|large>"<<""<<"code model (default: small)\n"
+        <<"\t"<<"-j <N>"<<"                           "<<"compile N input files in parallel (default: 1)\n"
+        <<"\t"<<"--modules"<<"                        "<<"compile every included .lorem file to it's own object, rebuild only changed ones\n"
+        <<"\t"<<"--codegen-threads=<N>"<<"            "<<"split module and generate machine code on N threads (default: 1)\n"
+        <<"\t"<<"--lto=<full|thin>"<<"                "<<"emit bitcode and optimize it together with bitcode libraries at link time\n"
+        <<"\t"<<"--in-memory"<<"                      "<<"pass object and runtime libraries to linker without temporary files\n"
+        <<"\t"<<"--cache-dir=<dir>"<<"                "<<"reuse executables of unchanged programs from build cache in dir\n"
+        <<"\t"<<"--cache-size=<MB>"<<"                "<<"least recently used cache entries are evicted above this size (default: 1024)\n"
+        <<"\t"<<"--time-trace=<file.json>"<<"          "<<"write chrome trace of compilation phases to file\n"
+        <<"\t"<<"--time-trace-granularity=<us>"<<"    "<<"minimum duration of traced events (default: 500)\n"
+        <<"\t"<<"-MD"<<"                              "<<"write Makefile rule with included files to <executable>.d\n"
+        <<"\t"<<"-MF <file>"<<"                       "<<"write Makefile rule to file instead (implies -MD)\n"
+        <<"\t"<<"--print-deps"<<"                     "<<"only resolve includes and print Makefile rule, nothing is compiled\n"
+        <<"\t"<<"--emit-module"<<"                    "<<"compile library to <name>.lmod, files including it use it instead of it's source\n"
+        << std::endl;
+}
+
+bool Driver::parseArguments(int argc, const char** argv, CompilerOptions* outOptions) {
+    CodeGenOptions& codeGenOptions = outOptions->codeGenOptions;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (outOptions->runInJit && !outOptions->inputFilePaths.empty()) { // everything after input file belongs to the program
+            outOptions->runArgs.emplace_back(arg);
+            continue;
+        }
+        if (arg == "--run") {
+            outOptions->runInJit = true;
+            continue;
+        }
+        if (arg == "--server") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --server requires socket path" << std::endl;
+                return false;
+            }
+            outOptions->serverSocket = argv[++i];
+            continue;
+        }
+        if (arg.starts_with("-j")) {
+            const char* value = arg.size() > 2 ? argv[i] + 2 : (i + 1 < argc ? argv[++i] : "");
+            char* end;
+            outOptions->jobs = std::strtoul(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || outOptions->jobs == 0) {
+                std::cerr << "Error: -j requires positive number of jobs" << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (arg.starts_with("--cache-dir=")) {
+            outOptions->cacheDir = arg.substr(arg.find('=') + 1);
+            continue;
+        }
+        if (arg.starts_with("--cache-size=")) {
+            const char* value = argv[i] + strlen("--cache-size=");
+            char* end;
+            const uint64_t sizeMB = std::strtoull(value, &end, 10);
+            if (!std::isdigit(static_cast<unsigned char>(*value)) || *end != '\0' || sizeMB == 0 || sizeMB > UINT64_MAX / (1024 * 1024)) {
+                std::cerr << "Error: --cache-size requires positive size in MB" << std::endl;
+                return false;
+            }
+            outOptions->cacheSizeBytes = sizeMB * 1024 * 1024;
+            continue;
+        }
+        if (arg == "-MD") {
+            outOptions->writeDepFile = true;
+            continue;
+        }
+        if (arg.starts_with("-MF")) {
+            const char* value = arg.size() > 3 ? argv[i] + 3 : (i + 1 < argc ? argv[++i] : "");
+            if (*value == '\0') {
+                std::cerr << "Error: -MF requires file path" << std::endl;
+                return false;
+            }
+            outOptions->depFile = value;
+            outOptions->writeDepFile = true;
+            continue;
+        }
+        if (arg == "--print-deps") {
+            outOptions->printDeps = true;
+            continue;
+        }
+        if (arg == "--emit-module") {
+            outOptions->emitModule = true;
+            continue;
+        }
+        if (arg == "--modules") {
+            outOptions->modules = true;
+            continue;
+        }
+        if (arg.starts_with("--codegen-threads=")) {
+            if (!parseUnsigned(argv[i] + strlen("--codegen-threads="), &codeGenOptions.codegenThreads) || codeGenOptions.codegenThreads == 0) {
+                std::cerr << "Error: --codegen-threads requires positive number of threads" << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (arg == "--in-memory") {
+            codeGenOptions.inMemory = true;
+            continue;
+        }
+        if (arg.starts_with("--time-trace=")) {
+            outOptions->timeTraceFile = argv[i] + strlen("--time-trace=");
+            continue;
+        }
+        if (arg.starts_with("--time-trace-granularity=")) {
+            if (!parseUnsigned(argv[i] + strlen("--time-trace-granularity="), &outOptions->timeTraceGranularity)) {
+                std::cerr << "Error: --time-trace-granularity requires number of microseconds" << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (Assembler::parseOptimizationLevel(arg, &codeGenOptions.optLevel)) {
+            continue;
+        }
+        if (arg.starts_with("--target-cpu=") || arg.starts_with("-march=")) {
+            codeGenOptions.targetCpu = arg.substr(arg.find('=') + 1);
+            continue;
+        }
+        if (arg.starts_with("--reloc=")) {
+            if (!Assembler::parseRelocModel(arg.substr(arg.find('=') + 1), &codeGenOptions.relocModel)) {
+                std::cerr << "Error: Unknown relocation model " << arg << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (arg.starts_with("--code-model=")) {
+            if (!Assembler::parseCodeModel(arg.substr(arg.find('=') + 1), &codeGenOptions.codeModel)) {
+                std::cerr << "Error: Unknown code model " << arg << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (arg.starts_with("--lto=")) {
+            if (!Assembler::parseLTOMode(arg.substr(arg.find('=') + 1), &codeGenOptions.lto)) {
+                std::cerr << "Error: Unknown lto mode " << arg << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (arg.starts_with("-")) {
+            std::cerr << "Error: Unknown option " << arg << std::endl;
+            return false;
+        }
+        outOptions->inputFilePaths.emplace_back(arg);
+    }
+
+    if (outOptions->inputFilePaths.empty() && outOptions->serverSocket.empty()) {
+        std::cerr << "Error: No input file" << std::endl;
+        return false;
+    }
+    if (outOptions->emitModule && outOptions->runInJit) {
+        std::cerr << "Error: --emit-module can't be used with --run" << std::endl;
+        return false;
+    }
+    if (!outOptions->depFile.empty() && outOptions->inputFilePaths.size() > 1) {
+        std::cerr << "Error: -MF accepts only one input file" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Driver::parseUnsigned(const char* value, unsigned* outValue) {
+    char* end;
+    errno = 0;
+    const unsigned long long number = std::strtoull(value, &end, 10);
+    if (!std::isdigit(static_cast<unsigned char>(*value)) || *end != '\0' || errno == ERANGE || number > UINT_MAX) {
+        return false;
+    }
+    *outValue = static_cast<unsigned>(number);
+    return true;
+}
+
+int Driver::run(const CompilerOptions& options) {
+    // Read Files
+    std::vector<std::filesystem::path> mainFilePaths;
+    for (const auto& inputFilePath : options.inputFilePaths) {
+        try {
+            mainFilePaths.push_back(std::filesystem::canonical(inputFilePath));
+        } catch([[maybe_unused]] std::filesystem::filesystem_error& e) {
+            std::cerr << "Error: Couldn't read the file " << inputFilePath << std::endl;
+            return 1;
+        }
+    }
+
+    // Build systems ask only for dependencies, files are printed in order of input files
+    if (options.printDeps) {
+        int result = 0;
+        for (const auto& mainFilePath : mainFilePaths) {
+            result = std::max(result, printDependencies(mainFilePath));
+        }
+        return result;
+    }
+
+    if (!options.timeTraceFile.empty()) {
+        llvm::timeTraceProfilerInitialize(options.timeTraceGranularity, "lsc");
+    }
+
+    int result;
+    if (mainFilePaths.size() == 1) {
+        llvm::TimeTraceScope compileScope("Compile", mainFilePaths[0].string());
+        result = compile(mainFilePaths[0], options);
+    } else {
+        result = compileBatch(mainFilePaths, options);
+    }
+
+    if (!options.timeTraceFile.empty()) {
+        if (auto error = llvm::timeTraceProfilerWrite(options.timeTraceFile, mainFilePaths[0].string())) {
+            llvm::errs() << "Error: Couldn't write time trace: " << llvm::toString(std::move(error)) << "\n";
+        }
+        llvm::timeTraceProfilerCleanup();
+    }
+    return result;
+}
+
+int Driver::compileBatch(const std::vector<std::filesystem::path>& mainFilePaths, const CompilerOptions& options) {
+    if (options.runInJit) {
+        std::cerr << "Error: --run accepts only one input file" << std::endl;
+        return 1;
+    }
+
+    Assembler::initializeTargets();
+
+    // Every compilation reads it's included files on it's own pool, together they use each core once
+    const unsigned parallelCompilations = std::min<unsigned>(options.jobs, mainFilePaths.size());
+    Preprocessor::setReadThreads(std::max(1u, llvm::hardware_concurrency().compute_thread_count() / parallelCompilations));
+
+    const bool timeTrace = llvm::timeTraceProfilerEnabled();
+    std::vector<std::ostringstream> diagnostics(mainFilePaths.size());
+    std::vector<std::ostringstream> logs(mainFilePaths.size()); // debug dumps and linker output
+    std::vector<int> results(mainFilePaths.size(), 0);
+    {
+        llvm::DefaultThreadPool threadPool(llvm::hardware_concurrency(options.jobs));
+        for (size_t i = 0; i < mainFilePaths.size(); i++) {
+            threadPool.async([&, i]() {
+                if (timeTrace) {
+                    llvm::timeTraceProfilerInitialize(options.timeTraceGranularity, "lsc");
+                }
+                ErrorHandler::setOutput(&diagnostics[i]);
+                ErrorHandler::setLogOutput(&logs[i]);
+                {
+                    llvm::TimeTraceScope compileScope("Compile", mainFilePaths[i].string());
+                    results[i] = compile(mainFilePaths[i], options);
+                }
+                ErrorHandler::setOutput(&std::cerr);
+                ErrorHandler::setLogOutput(&std::cout);
+                if (timeTrace) {
+                    llvm::timeTraceProfilerFinishThread();
+                }
+            });
+        }
+        threadPool.wait();
+    }
+    Preprocessor::setReadThreads(0);
+
+    int result = 0;
+    for (size_t i = 0; i < mainFilePaths.size(); i++) {
+        std::cout << logs[i].str() << std::flush;
+        std::string fileDiagnostics = diagnostics[i].str();
+        if (!fileDiagnostics.empty()) {
+            std::cerr << "In " << mainFilePaths[i].string() << ":" << fileDiagnostics << std::endl;
+        }
+        if (result == 0) {
+            result = results[i];
+        }
+    }
+    return result;
+}
+
+int Driver::compile(const std::filesystem::path& mainFilePath, const CompilerOptions& options) {
+    ErrorHandler::reset(); // errors of previous compilation (in compile server) must not leak into this one
+
+    // each phase of the compiler is a separate scope in time trace
+    std::optional<llvm::TimeTraceScope> phaseScope;
+
+    // Preprocess
+    // NOTE: Modules are built from sources only, separately compiled units (--modules) are cached as objects already
+    phaseScope.emplace("Preprocess");
+    Preprocessor preprocessor = Preprocessor(mainFilePath, false, !options.modules && !options.emitModule);
+    const std::u8string& sourceCode = preprocessor.getMergedSourceCode();
+    
+    ErrorHandler::init(preprocessor.getSourceManager()); // initialize ErrorHandler with source files
+    if(ErrorHandler::hasError()) { // check if any errors occured
+        return 1;
+    }
+
+    if (options.emitModule) {
+        phaseScope.reset();
+        return ModuleCompiler::emitPrecompiledModule(preprocessor, mainFilePath) ? 0 : 1;
+    }
+
+    std::filesystem::path outputDir = mainFilePath.parent_path();
+    std::filesystem::path exeFilePath = getExecutablePath(mainFilePath);
+
+    // Depfile is written even if executable is taken from build cache, it's rule has to be complete
+    if (options.writeDepFile && !options.runInJit && !writeDepFile(preprocessor, exeFilePath, options)) {
+        return 1;
+    }
+
+    // Unchanged program was already built, reuse it's executable
+    std::optional<BuildCache> buildCache;
+    std::string cacheKey;
+    if (!options.cacheDir.empty() && !options.runInJit) {
+        phaseScope.emplace("Build cache lookup");
+        buildCache.emplace(options.cacheDir, options.cacheSizeBytes);
+        // Precompiled modules aren't part of merged source code, they are part of key like libraries
+        std::vector<std::filesystem::path> keyFiles = preprocessor.getLinkLibs();
+        for (const auto& module : preprocessor.getPrecompiledModules()) {
+            keyFiles.push_back(module->getFilePath());
+        }
+        cacheKey = BuildCache::computeKey(sourceCode, keyFiles, options.codeGenOptions);
+        if (buildCache->fetch(cacheKey, exeFilePath)) {
+            return 0;
+        }
+    }
+
+    if (options.modules && !options.runInJit) {
+        phaseScope.reset();
+        if (compileModules(preprocessor, mainFilePath, exeFilePath, options) != 0) {
+            return 1;
+        }
+        if (buildCache) {
+            buildCache->store(cacheKey, exeFilePath);
+        }
+        return 0;
+    }
+
+    // Tokenize and parse, parser pulls tokens from lexer as it goes
+    phaseScope.emplace("Parse");
+    Lexer lexer = Lexer(sourceCode);
+    TokenStream tokens = TokenStream(lexer, ErrorHandler::getLogOutput());
+    Parser parser = Parser(tokens);
+    for (const auto& module : preprocessor.getPrecompiledModules()) {
+        for (const auto& structName : module->getStructNames()) {
+            parser.addStructName(structName);
+        }
+    }
+    std::unique_ptr<AST> tree = parser.parse();
+    
+    if (ErrorHandler::hasError()) { // check if any errors occured
+        return 1;
+    }
+
+    // Generate IR, precompiled modules are declared before and linked after the program
+    phaseScope.emplace("Generate IR");
+    IRGenerator codeGenerator = IRGenerator(mainFilePath.stem().string().c_str(), tree);
+    for (const auto& module : preprocessor.getPrecompiledModules()) {
+        codeGenerator.generateInterface(module->getInterface());
+    }
+    codeGenerator.generateIRCode();
+    for (const auto& module : preprocessor.getPrecompiledModules()) {
+        codeGenerator.linkModule(module->getBitcode());
+    }
+
+    if (ErrorHandler::hasError()) { // check if any errors occured
+        return 1;
+    }
+    phaseScope.reset(); // Assembler traces it's own phases
+
+    const CodeGenOptions& codeGenOptions = options.codeGenOptions;
+    if (options.runInJit) {
+        JITRunner jitRunner = JITRunner(codeGenOptions);
+        return jitRunner.run(codeGenerator.takeModule(), preprocessor.getLinkLibs(), mainFilePath.string(), options.runArgs);
+    }
+
+    // Assemble
+    std::filesystem::path objFilePath = outputDir / mainFilePath.stem();
+    objFilePath += ".o";
+    
+    Assembler assembler = Assembler(codeGenOptions);
+    auto libs = preprocessor.getLinkLibs();
+    bool linked;
+    if (codeGenOptions.inMemory) {
+        std::vector<ObjectBuffer> objectBuffers;
+        linked = assembler.compileToObjectBuffers(&objectBuffers, codeGenerator.getModule())
+            && assembler.compileToExecutable(objectBuffers, exeFilePath, libs);
+    } else {
+        std::vector<std::filesystem::path> objectFiles;
+        linked = assembler.compileToObjectFiles(objFilePath, codeGenerator.getModule(), &objectFiles)
+            && assembler.compileToExecutable(objectFiles, exeFilePath, libs);
+        #ifdef NDEBUG
+        if (linked) {
+            for (const auto& objectFile : objectFiles) {
+                std::filesystem::remove(objectFile);
+            }
+        }
+        #endif
+    }
+
+    if (!linked) {
+        return 1;
+    }
+    if (buildCache) {
+        buildCache->store(cacheKey, exeFilePath);
+    }
+    return 0;
+}
+
+std::filesystem::path Driver::getExecutablePath(const std::filesystem::path& mainFilePath) {
+    std::filesystem::path exeFilePath = mainFilePath.parent_path() / mainFilePath.stem();
+    #ifdef _WIN32
+        exeFilePath += ".exe";
+    #endif
+    return exeFilePath;
+}
+
+int Driver::printDependencies(const std::filesystem::path& mainFilePath) {
+    ErrorHandler::reset();
+    Preprocessor preprocessor = Preprocessor(mainFilePath, true);
+    if (ErrorHandler::hasError()) {
+        return 1;
+    }
+    preprocessor.writeDependencies(std::cout, getExecutablePath(mainFilePath));
+    return 0;
+}
+
+bool Driver::writeDepFile(const Preprocessor& preprocessor, const std::filesystem::path& exeFilePath, const CompilerOptions& options) {
+    std::filesystem::path depFilePath = options.depFile;
+    if (depFilePath.empty()) {
+        depFilePath = exeFilePath;
+        depFilePath += ".d";
+    }
+
+    std::ofstream depFile = std::ofstream(depFilePath);
+    preprocessor.writeDependencies(depFile, exeFilePath);
+    if (!depFile) {
+        ErrorHandler::logError(u8"Couldn't write dependency file " + depFilePath.u8string() + u8"!");
+        return false;
+    }
+    return true;
+}
+
+int Driver::compileModules(const Preprocessor& preprocessor, const std::filesystem::path& mainFilePath, const std::filesystem::path& exeFilePath, const CompilerOptions& options) {
+    std::filesystem::path objectDir = mainFilePath.parent_path() / mainFilePath.stem();
+    objectDir += ".modules";
+
+    ModuleCompiler moduleCompiler = ModuleCompiler(preprocessor, options.codeGenOptions, options.jobs, options.timeTraceGranularity, objectDir);
+    std::vector<std::filesystem::path> objectFiles;
+    if (!moduleCompiler.compile(&objectFiles)) {
+        return 1;
+    }
+
+    Assembler assembler = Assembler(options.codeGenOptions);
+    auto libs = preprocessor.getLinkLibs();
+    return assembler.compileToExecutable(objectFiles, exeFilePath, libs) ? 0 : 1;
+}
@@ -1,17 +1,35 @@
 #include "ErrorHandler.hpp"
 
 ErrorHandler* ErrorHandler::getInstance() {
-    if(s_instance == nullptr) {
-        std::lock_guard<std::mutex> lock(s_mutex); // Lock the mutex to ensure thread safety
-        if(s_instance == nullptr) { // Double-check if instance is still null
-            s_instance = new ErrorHandler(); // Create the singleton instance
-        }
-    }
-    return s_instance; // Return the singleton instance
+    thread_local ErrorHandler instance; // every compiling thread has it's own source lines and flags
+    return &instance;
+}
+
+void ErrorHandler::init(const SourceManager& sources) {
+    getInstance()->m_sources = &sources; // Initialize the source manager reference
+}
+
+void ErrorHandler::reset() {
+    auto& instance = *getInstance();
+    instance.m_sources = nullptr;
+    instance.m_errorFlag = false;
+    instance.m_warnFlag = false;
+}
+
+void ErrorHandler::setOutput(std::ostream* ostr) {
+    getInstance()->m_output = ostr;
+}
+
+std::ostream& ErrorHandler::getOutput() {
+    return *getInstance()->m_output;
+}
+
+void ErrorHandler::setLogOutput(std::ostream* ostr) {
+    getInstance()->m_logOutput = ostr;
 }
 
-void ErrorHandler::init(const std::vector<SourceLine>& lines) {
-    getInstance()->m_sourceLines = &lines; // Initialize the source lines reference
+std::ostream& ErrorHandler::getLogOutput() {
+    return *getInstance()->m_logOutput;
 }
 
 bool ErrorHandler::hasError() {
@@ -47,13 +65,12 @@ void ErrorHandler::logWarning(std::u8string reason) {
 }
 
 void ErrorHandler::log(size_t* line, std::u8string reason, bool isError) {
-    const SourceLine* sourceLine = nullptr; // Initialize sourceLine pointer to null
+    std::optional<SourceLocation> location; // file and line of merged line
     if (line) {
-        if(!m_sourceLines) {
+        if(!m_sources) {
             return; // Ensure source lines are initialized. Can't assert, because of testing
         } else  {
-            assert(*line - 1 < m_sourceLines->size());
-            sourceLine = &(*m_sourceLines)[*line - 1]; // Get the source lines reference
+            location = m_sources->getLocation(*line - 1);
         }
     }
     
@@ -63,14 +80,18 @@ void ErrorHandler::log(size_t* line, std::u8string reason, bool isError) {
     std::string outputStr;
     std::stringstream outputStream(outputStr);
     outputStream << (isError ? ERROR_STR : WARNING_STR); // Set the error or warning string
-    if (sourceLine) {
-        outputStream << "\x1b]8;;vscode://file/"+ sourceLine->filePath.string() << ":" << std::to_string(sourceLine->lineIndexInFile + 1); // link
-        outputStream << "\x1b\\" << (const char*)toRomanConverter(sourceLine->lineIndexInFile + 1).c_str() << "\x1b]8;;\x1b\\" << " in File: "+ sourceLine->filePath.string() << "\n"; // link title
-        outputStream << "\t \033[31m:" << (const char*)(sourceLine->line.c_str()) << "\033[0m \n"; // line content
+    if (location) {
+        const std::string filePathStr = m_sources->getFilePath(location->file).string();
+        std::u8string_view lineText = m_sources->getLine(location->file, location->lineIndexInFile);
+        RomanBuffer lineNumberBuffer;
+        std::u8string_view lineNumber = toRomanConverter(location->lineIndexInFile + 1, lineNumberBuffer);
+        outputStream << "\x1b]8;;vscode://file/"+ filePathStr << ":" << std::to_string(location->lineIndexInFile + 1); // link
+        outputStream << "\x1b\\" << std::string_view((const char*)lineNumber.data(), lineNumber.size()) << "\x1b]8;;\x1b\\" << " in File: "+ filePathStr << "\n"; // link title
+        outputStream << "\t \033[31m:" << std::string_view((const char*)lineText.data(), lineText.size()) << (lineText.ends_with(u8'\n') ? "" : "\n") << "\033[0m \n"; // line content
     } else {
         outputStream << "In undefined line"; // Unknown file case
     }
 
     outputStream << "possible Reason: " << (const char*)reason.c_str() << std::endl; // reason 
-    std::cerr << outputStream.str() << std::endl;
+    *m_output << outputStream.str() << std::endl;
 }
@@ -39,8 +39,9 @@ void SymbolTable::addGlobal(const std::u8string& name, const IDataType* type, ll
     m_globals.emplace_back(&name, type, value);
 }
 
-void SymbolTable::addFunction(const std::u8string& name, const IDataType* type, llvm::Value* value) {
+void SymbolTable::addFunction(const std::u8string& name, const IDataType* type, llvm::Value* value, const std::vector<const IDataType*>& argTypes) {
     m_functions.emplace_back(&name, type, value);
+    m_functions.back().argTypes = argTypes;
 }
 
 void SymbolTable::addStruct(const std::u8string& name, const StructDataType* type) {
@@ -44,15 +44,51 @@ void IRGenerator::generateIRCode() {
     m_root->codegen(m_context);
 
     #if !defined(NDEBUG)
-    std::cout << "----------------------- LLVM IR Code: ----------------------- " << std::endl << std::endl;
-    std::cout << getIRCodeString() << std::endl;
+    std::ostream& log = ErrorHandler::getLogOutput();
+    log << "----------------------- LLVM IR Code: ----------------------- " << std::endl << std::endl;
+    log << getIRCodeString() << std::endl;
     #endif
 }
 
+void IRGenerator::generateInterface(AST* importedRoot) {
+    m_context.declarationsOnly = true;
+    importedRoot->codegen(m_context);
+    m_context.declarationsOnly = false;
+}
+
+void IRGenerator::generateModuleIRCode(const char* initFunctionName) {
+    m_root->codegen(m_context);
+
+    llvm::Function* initFunction = m_context.theModule->getFunction(initFunctionName);
+    if (initFunction && !initFunction->empty()) {
+        llvm::appendToGlobalCtors(*m_context.theModule, initFunction, 65535);
+    }
+}
+
+void IRGenerator::linkModule(llvm::MemoryBufferRef bitcode) {
+    llvm::TimeTraceScope scope("Link module", bitcode.getBufferIdentifier());
+    const std::string moduleName = bitcode.getBufferIdentifier().str();
+
+    auto module = llvm::parseBitcodeFile(bitcode, *m_context.context);
+    if (!module) {
+        const std::string message = llvm::toString(module.takeError());
+        ErrorHandler::logError(u8"Couldn't read precompiled module " + std::u8string(moduleName.begin(), moduleName.end()) + u8": " + std::u8string(message.begin(), message.end()));
+        return;
+    }
+    if (llvm::Linker::linkModules(*m_context.theModule, std::move(*module))) {
+        ErrorHandler::logError(u8"Couldn't link precompiled module " + std::u8string(moduleName.begin(), moduleName.end()) + u8"!");
+    }
+}
+
 llvm::Module* IRGenerator::getModule() {
     return m_context.theModule.get();
 }
 
+llvm::orc::ThreadSafeModule IRGenerator::takeModule() {
+    m_context.builder.reset(); // builder refers to context
+    return llvm::orc::ThreadSafeModule(std::move(m_context.theModule), std::move(m_context.context));
+}
+
 std::string IRGenerator::getIRCodeString() {
     std::string IRCode;
     llvm::raw_string_ostream outStream(IRCode);
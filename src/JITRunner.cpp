@@ -0,0 +1,122 @@
+#include "JITRunner.hpp"
+
+using namespace llvm::orc;
+
+JITRunner::JITRunner(const CodeGenOptions& options)
+    : m_options(options) {
+    // NOTE: There is no link step in jit, so module is optimized fully right away
+    m_options.lto = LTOMode::None;
+}
+
+int JITRunner::run(ThreadSafeModule module, const std::vector<std::filesystem::path>& linkLibraries, const std::string& programName, const std::vector<std::string>& programArgs) {
+    TimeTraceScope scope("JIT");
+
+    InitializeNativeTarget();
+    InitializeNativeTargetAsmPrinter();
+    InitializeNativeTargetAsmParser();
+
+    auto targetMachineBuilder = JITTargetMachineBuilder::detectHost();
+    if (!targetMachineBuilder) {
+        llvm::errs() << "Error: " << toString(targetMachineBuilder.takeError()) << "\n";
+        return 1;
+    }
+    // NOTE: Code runs on this machine, so host cpu is default, unless other one is requested
+    if (m_options.targetCpu != "generic" && m_options.targetCpu != "native") {
+        targetMachineBuilder->setCPU(m_options.targetCpu);
+    }
+    targetMachineBuilder->setCodeGenOptLevel(Assembler::getCodeGenOptLevel(m_options.optLevel));
+
+    // Run same IR pipeline as ahead of time compilation
+    auto targetMachine = targetMachineBuilder->createTargetMachine();
+    if (!targetMachine) {
+        llvm::errs() << "Error: " << toString(targetMachine.takeError()) << "\n";
+        return 1;
+    }
+    module.withModuleDo([&](Module& theModule) {
+        theModule.setTargetTriple(targetMachineBuilder->getTargetTriple().str());
+        theModule.setDataLayout((*targetMachine)->createDataLayout());
+        Assembler(m_options).optimizeModule(&theModule, targetMachine->get());
+    });
+
+    auto jit = LLJITBuilder().setJITTargetMachineBuilder(std::move(*targetMachineBuilder)).create();
+    if (!jit) {
+        llvm::errs() << "Error: " << toString(jit.takeError()) << "\n";
+        return 1;
+    }
+
+    JITDylib& mainLibrary = (*jit)->getMainJITDylib();
+    auto processSymbols = DynamicLibrarySearchGenerator::GetForCurrentProcess((*jit)->getDataLayout().getGlobalPrefix());
+    if (!processSymbols) {
+        llvm::errs() << "Error: " << toString(processSymbols.takeError()) << "\n";
+        return 1;
+    }
+    mainLibrary.addGenerator(std::move(*processSymbols));
+
+    for (const auto& library : linkLibraries) {
+        if (Error error = addLinkLibrary(jit->get(), library)) {
+            llvm::errs() << "Error: Couldn't load " << library.string() << ": " << toString(std::move(error)) << "\n";
+            return 1;
+        }
+    }
+
+    if (Error error = (*jit)->addIRModule(std::move(module))) {
+        llvm::errs() << "Error: " << toString(std::move(error)) << "\n";
+        return 1;
+    }
+
+    auto mainSymbol = (*jit)->lookup("main");
+    if (!mainSymbol) {
+        llvm::errs() << "Error: " << toString(mainSymbol.takeError()) << "\n";
+        return 1;
+    }
+
+    // Static constructors (global_ctors) of the module
+    if (Error error = (*jit)->initialize(mainLibrary)) {
+        llvm::errs() << "Error: " << toString(std::move(error)) << "\n";
+        return 1;
+    }
+
+    int exitCode;
+    {
+        TimeTraceScope mainScope("Run main");
+        auto* mainFunction = mainSymbol->toPtr<int (*)(int, char*[])>();
+        exitCode = runAsMain(mainFunction, programArgs, StringRef(programName));
+    }
+    llvm::outs().flush();
+    fflush(stdout);
+
+    if (Error error = (*jit)->deinitialize(mainLibrary)) {
+        llvm::errs() << "Error: " << toString(std::move(error)) << "\n";
+    }
+    return exitCode;
+}
+
+Error JITRunner::addLinkLibrary(LLJIT* jit, const std::filesystem::path& libraryPath) {
+    const std::string path = libraryPath.string();
+    const auto extension = libraryPath.extension();
+
+    if (extension == ".a") {
+        auto generator = StaticLibraryDefinitionGenerator::Load(jit->getObjLinkingLayer(), path.c_str());
+        if (!generator) {
+            return generator.takeError();
+        }
+        jit->getMainJITDylib().addGenerator(std::move(*generator));
+        return Error::success();
+    }
+
+    if (extension == ".so" || extension == ".dll") {
+        auto generator = DynamicLibrarySearchGenerator::Load(path.c_str(), jit->getDataLayout().getGlobalPrefix());
+        if (!generator) {
+            return generator.takeError();
+        }
+        jit->getMainJITDylib().addGenerator(std::move(*generator));
+        return Error::success();
+    }
+
+    // .o
+    auto buffer = MemoryBuffer::getFile(path);
+    if (!buffer) {
+        return errorCodeToError(buffer.getError());
+    }
+    return jit->addObjectFile(std::move(*buffer));
+}
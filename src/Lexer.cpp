@@ -3,7 +3,8 @@
 Lexer::Lexer(const std::u8string& sourceCode) 
     : m_souceCode(&sourceCode)
     , m_charIterator(0)
-    , m_lineCounter(0) {}
+    , m_lineCounter(0)
+    , m_identifierIds() {}
 
 void Lexer::tokenize(std::vector<Token>& outTokens, std::ostream &ostr) {
     Token token;
@@ -17,19 +18,19 @@ void Lexer::tokenize(std::vector<Token>& outTokens, std::ostream &ostr) {
     #if !defined(NDEBUG)
     ostr << "----------------------- Tokens: ----------------------- " << std::endl << std::endl;
     for(const auto& token : outTokens) {
-        ostr << TOKEN_TYPE_LABELS[(int)token.type] << ": " << (const char*)(token.value.c_str()) << std::endl;
+        printToken(ostr, token);
     }
     ostr << std::endl;
     #endif
 }
 
+void Lexer::printToken(std::ostream &ostr, const Token& token) {
+    ostr << TOKEN_TYPE_LABELS[(int)token.type] << ": " << std::string_view((const char*)token.value.data(), token.value.size()) << std::endl;
+}
+
 Token Lexer::getNextToken() {
     // ignore any whitespace, tab, ect.
-    while ( getCharAt(m_charIterator) == u8' ' || 
-            getCharAt(m_charIterator) == u8'\r' ||
-            getCharAt(m_charIterator) == u8'\t') {
-        m_charIterator++;
-    }
+    m_charIterator = findFirstNotOf(m_charIterator, lexer_scan::BLANKS);
 
     // End of the file
     if (getCharAt(m_charIterator) == u8'\0') {
@@ -45,131 +46,95 @@ Token Lexer::getNextToken() {
 
     // if literal
     if (getCharAt(m_charIterator) == punctuation::APOSTROPHE[0]) {
-        std::u8string literraSymbol = u8"";
         m_charIterator++; // skip '
+        size_t start = m_charIterator;
         // NOTE(Vlad):  it's allowed here to input multiple symbols to literal, 
         //              parser should not let literal with multiple symbols inside
-        while (getCharAt(m_charIterator) != punctuation::APOSTROPHE[0]) {
-            if (getCharAt(m_charIterator) == u8'\0') {
-                ErrorHandler::logError(u8"No closing apostrophe found!", m_lineCounter);
-                return {TokenType::EOF_TOKEN, u8""};
-            }
-            literraSymbol += getCharAt(m_charIterator);
-            m_charIterator++;
+        m_charIterator = findFirstOf(m_charIterator, lexer_scan::LITERAL_ENDS);
+        if (getCharAt(m_charIterator) == u8'\0') {
+            ErrorHandler::logError(u8"No closing apostrophe found!", m_lineCounter);
+            return {TokenType::EOF_TOKEN, u8""};
         }
-        if (getCharAt(m_charIterator) == punctuation::APOSTROPHE[0]) {
-            m_charIterator++; // skip '
-        }
-        return {TokenType::LITERAL, std::move(literraSymbol)};
+        std::u8string_view literraSymbol = getSourceView(start, m_charIterator);
+        m_charIterator++; // skip '
+        return {TokenType::LITERAL, literraSymbol};
     }
 
     // if string
     if (getCharAt(m_charIterator) == punctuation::QUOTE[0]) {
-        std::u8string string = u8"";
         m_charIterator++; // skip "
-        while (getCharAt(m_charIterator) != punctuation::QUOTE[0]) {
-            if (getCharAt(m_charIterator) == u8'\0') {
-                ErrorHandler::logError(u8"No closing quote found!", m_lineCounter);
-                return {TokenType::EOF_TOKEN, u8""};
-            }
-            string += getCharAt(m_charIterator);
-            m_charIterator++;
-        }
-        if (getCharAt(m_charIterator) == punctuation::QUOTE[0]) {
-            m_charIterator++; // skip "
+        size_t start = m_charIterator;
+        m_charIterator = findFirstOf(m_charIterator, lexer_scan::STRING_ENDS);
+        if (getCharAt(m_charIterator) == u8'\0') {
+            ErrorHandler::logError(u8"No closing quote found!", m_lineCounter);
+            return {TokenType::EOF_TOKEN, u8""};
         }
-        return {TokenType::STRING, std::move(string)};
-    }
-
-    // is punctuation
-    for (size_t i = 0; i < punctuation::VALUES_SIZE; i++) {
-        if (getCharAt(m_charIterator) == punctuation::VALUES[i][0]) {
-            std::u8string puctuationSymbol = u8"";
-            puctuationSymbol += getCharAt(m_charIterator);
-            m_charIterator++;
-            return {TokenType::PUNCTUATION, std::move(puctuationSymbol)};
-        }
-    }
-
-    // is boolean
-    int boolIndex = startWithWord(boolean_types::VALUES, boolean_types::VALUES_SIZE, false);
-    if (boolIndex != -1) {
-        m_charIterator += boolean_types::VALUES[boolIndex].length();
-        return {TokenType::BOOL, std::u8string(boolean_types::VALUES[boolIndex])};
-    }
-
-    // is keyword
-    int keywordIndex = startWithWord(keywords::VALUES, keywords::VALUES_SIZE, false);
-    if (keywordIndex != -1) {
-        m_charIterator += keywords::VALUES[keywordIndex].length();
-        return {TokenType::KEYWORD, std::u8string(keywords::VALUES[keywordIndex])};
-    }
-
-    // is type
-    int typeIndex = startWithWord(types::VALUES, types::VALUES_SIZE, false);
-    if (typeIndex != -1) {
-        m_charIterator += types::VALUES[typeIndex].length();
-        return {TokenType::TYPE, std::u8string(types::VALUES[typeIndex])};
+        std::u8string_view string = getSourceView(start, m_charIterator);
+        m_charIterator++; // skip "
+        return {TokenType::STRING, string};
     }
 
     // if comment
     if (getCharAt(m_charIterator) == u8'/' && getCharAt(m_charIterator+1) == '/') {
-        while (getCharAt(m_charIterator) != u8'\n' && getCharAt(m_charIterator) != '\0') {
-            m_charIterator++;
-        }
+        m_charIterator = findFirstOf(m_charIterator, lexer_scan::LINE_ENDS);
         return getNextToken();
     }
 
-    // is operator
-    int operatorIndex = startWithWord(operators::VALUES, operators::VALUES_SIZE, true);
-    if (operatorIndex != -1) {
-        m_charIterator += operators::VALUES[operatorIndex].length();
-        return {TokenType::OPERATOR, std::u8string(operators::VALUES[operatorIndex])};
+    // is punctuation, operator, boolean, keyword or type
+    lexer_trie::Match match = lexer_trie::matchLongest(m_souceCode->c_str() + m_charIterator);
+    if (match.wordIndex != -1) {
+        const lexer_trie::Word& word = lexer_trie::WORDS[match.wordIndex];
+        char8_t character = getCharAt(m_charIterator + match.length);
+        // if identifier continues after word of letters, the whole thing is identifier
+        if (lexer_trie::isSymbol(word.type) || character < u8'a' || character > u8'z') {
+            size_t start = m_charIterator;
+            m_charIterator += match.length;
+            return {word.type, getSourceView(start, m_charIterator), word.kind};
+        }
     }
 
     // if number
-    if (getCharAt(m_charIterator) >= u8'A' && getCharAt(m_charIterator) <= 'Z') {
-        std::u8string numberStr = u8"";
-        while (getCharAt(m_charIterator) >= u8'A' && getCharAt(m_charIterator) <= u8'Z') {
-            numberStr += getCharAt(m_charIterator);
+    // groups of thousands are separated by '_', e.g. XLII_O_VII
+    auto isUpper = [](char8_t character) { return character >= u8'A' && character <= u8'Z'; };
+    if (isUpper(getCharAt(m_charIterator))) {
+        size_t start = m_charIterator;
+        while (isUpper(getCharAt(m_charIterator))
+            || (getCharAt(m_charIterator) == roman_number::GROUP_SEPARATOR && isUpper(getCharAt(m_charIterator + 1)))) {
             m_charIterator++;
         }
-        return {TokenType::NUMBER, std::move(numberStr)};
+        return {TokenType::NUMBER, getSourceView(start, m_charIterator)};
     }
 
     // if identifier
-    std::u8string identifierStr = u8"";
-    while ( getCharAt(m_charIterator) != u8' ' && 
-            getCharAt(m_charIterator) != u8'\n' && 
-            getCharAt(m_charIterator) != u8'\r' && 
-            getCharAt(m_charIterator) != u8'\0' && 
-            startWithWord(operators::VALUES, operators::VALUES_SIZE, true) == -1 &&
-            startWithWord(punctuation::VALUES, punctuation::VALUES_SIZE, true) == -1) {
-        identifierStr += getCharAt(m_charIterator);
-        m_charIterator++;
+    // ends at whitespace, new line, end of the file or punctuation/operator
+    size_t start = m_charIterator;
+    while (true) {
+        m_charIterator = findFirstOf(m_charIterator, lexer_scan::IDENTIFIER_ENDS);
+        if (!lexer_trie::SYMBOL_STARTS[getCharAt(m_charIterator)] || lexer_trie::startsWithSymbol(m_souceCode->c_str() + m_charIterator)) {
+            break;
+        }
+        m_charIterator++; // byte only looked like start of operator (e.g. lead byte of other UTF-8 character)
     }
-    return {TokenType::IDENTIFIER, std::move(identifierStr)};
+    std::u8string_view identifier = getSourceView(start, m_charIterator);
+    // ids start at 1, 0 is left for tokens which aren't identifiers
+    auto [iter, inserted] = m_identifierIds.try_emplace(identifier, static_cast<uint32_t>(m_identifierIds.size() + 1));
+    return {TokenType::IDENTIFIER, identifier, TokenKind::NONE, iter->second};
 }
 
+char8_t Lexer::getCharAt(size_t index) const {
+    return (*m_souceCode)[index];
+}
 
-int Lexer::startWithWord(const std::u8string_view* words, size_t wordsSize, bool allowIdentifierAfter) const {
-    for (size_t i = 0; i < wordsSize; i++) {
-        const std::u8string_view& word = words[i];
-        std::u8string_view subString(m_souceCode->c_str() + m_charIterator, word.length());
-        if (subString.starts_with(word)) {
-            if (!allowIdentifierAfter) {
-                char8_t character = getCharAt(m_charIterator + word.length());
-                if (character >= u8'a' && character <= u8'z') {
-                    // there is some identifier after. So, the whole thing is identifier
-                    return -1;
-                }
-            }
-            return i;
-        }
-    }
-    return -1;
+size_t Lexer::findFirstOf(size_t index, const lexer_scan::ByteSet& set) const {
+    const char8_t* begin = m_souceCode->data();
+    return lexer_scan::findFirstOf(begin + index, begin + m_souceCode->size(), set) - begin;
 }
 
-char8_t Lexer::getCharAt(int index) const {
-    return (*m_souceCode)[index];
+size_t Lexer::findFirstNotOf(size_t index, const lexer_scan::ByteSet& set) const {
+    const char8_t* begin = m_souceCode->data();
+    return lexer_scan::findFirstNotOf(begin + index, begin + m_souceCode->size(), set) - begin;
+}
+
+std::u8string_view Lexer::getSourceView(size_t start, size_t end) const {
+    return std::u8string_view(*m_souceCode).substr(start, end - start);
 }
@@ -0,0 +1,123 @@
+#include <assert.h>
+#include "LexerScan.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LSC_X86_KERNELS
+#endif
+
+namespace lexer_scan {
+    using FindFunction = const char8_t* (*)(const char8_t* begin, const char8_t* end, const ByteSet& set);
+
+    struct Kernels {
+        FindFunction findFirstOf;
+        FindFunction findFirstNotOf;
+    };
+
+    // IS_NOT_OF: looking for first byte outside of set instead of first byte inside
+    template <bool IS_NOT_OF>
+    static const char8_t* findScalar(const char8_t* begin, const char8_t* end, const ByteSet& set) {
+        while (begin != end && set.contains[*begin] == IS_NOT_OF) {
+            begin++;
+        }
+        return begin;
+    }
+
+    #if defined(LSC_X86_KERNELS)
+    template <bool IS_NOT_OF>
+    __attribute__((target("ssse3")))
+    static const char8_t* findSSSE3(const char8_t* begin, const char8_t* end, const ByteSet& set) {
+        const __m128i lowTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbles.data()));
+        const __m128i highTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbles.data()));
+        const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+
+        while (end - begin >= 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+            const __m128i low = _mm_shuffle_epi8(lowTable, _mm_and_si128(bytes, nibbleMask));
+            const __m128i high = _mm_shuffle_epi8(highTable, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask));
+            uint32_t outside = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128()));
+            uint32_t found = IS_NOT_OF ? outside : ~outside & 0xFFFF;
+            if (found != 0) {
+                return begin + __builtin_ctz(found);
+            }
+            begin += 16;
+        }
+        return findScalar<IS_NOT_OF>(begin, end, set);
+    }
+
+    template <bool IS_NOT_OF>
+    __attribute__((target("avx2")))
+    static const char8_t* findAVX2(const char8_t* begin, const char8_t* end, const ByteSet& set) {
+        // shuffle looks up each 128-bit lane separately, so both lanes get the table
+        const __m256i lowTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbles.data())));
+        const __m256i highTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbles.data())));
+        const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+
+        while (end - begin >= 32) {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+            const __m256i low = _mm256_shuffle_epi8(lowTable, _mm256_and_si256(bytes, nibbleMask));
+            const __m256i high = _mm256_shuffle_epi8(highTable, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask));
+            uint32_t outside = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256()));
+            uint32_t found = IS_NOT_OF ? outside : ~outside;
+            if (found != 0) {
+                return begin + __builtin_ctz(found);
+            }
+            begin += 32;
+        }
+        return findSSSE3<IS_NOT_OF>(begin, end, set);
+    }
+    #endif
+
+    static Kernels getKernels(SimdLevel level) {
+        #if defined(LSC_X86_KERNELS)
+        switch (level) {
+            case SimdLevel::AVX2:
+                return {findAVX2<false>, findAVX2<true>};
+            case SimdLevel::SSSE3:
+                return {findSSSE3<false>, findSSSE3<true>};
+            case SimdLevel::SCALAR:
+                break;
+        }
+        #endif
+        return {findScalar<false>, findScalar<true>};
+    }
+
+    static const Kernels& getBestKernels() {
+        static const Kernels kernels = getKernels(getSimdLevel());
+        return kernels;
+    }
+
+    SimdLevel getSimdLevel() {
+        static const SimdLevel level = [] {
+            #if defined(LSC_X86_KERNELS)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return SimdLevel::AVX2;
+            }
+            if (__builtin_cpu_supports("ssse3")) {
+                return SimdLevel::SSSE3;
+            }
+            #endif
+            return SimdLevel::SCALAR;
+        }();
+        return level;
+    }
+
+    const char8_t* findFirstOfWide(const char8_t* begin, const char8_t* end, const ByteSet& set) {
+        return getBestKernels().findFirstOf(begin, end, set);
+    }
+
+    const char8_t* findFirstOf(const char8_t* begin, const char8_t* end, const ByteSet& set, SimdLevel level) {
+        assert(level <= getSimdLevel());
+        return getKernels(level).findFirstOf(begin, end, set);
+    }
+
+    const char8_t* findFirstNotOfWide(const char8_t* begin, const char8_t* end, const ByteSet& set) {
+        return getBestKernels().findFirstNotOf(begin, end, set);
+    }
+
+    const char8_t* findFirstNotOf(const char8_t* begin, const char8_t* end, const ByteSet& set, SimdLevel level) {
+        assert(level <= getSimdLevel());
+        return getKernels(level).findFirstNotOf(begin, end, set);
+    }
+}
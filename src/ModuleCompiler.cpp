@@ -0,0 +1,238 @@
+#include "ModuleCompiler.hpp"
+
+ModuleCompiler::ModuleCompiler(const Preprocessor& preprocessor, const CodeGenOptions& options, unsigned jobs, unsigned timeTraceGranularity, const std::filesystem::path& objectDir)
+    : m_options(options)
+    , m_jobs(jobs)
+    , m_timeTraceGranularity(timeTraceGranularity)
+    , m_objectDir(objectDir)
+    , m_units() 
+{
+    for (const LoremSourceFile* file : preprocessor.getModuleUnits()) {
+        auto unit = std::make_unique<ModuleUnit>();
+        unit->file = file;
+        const std::string pathStr = file->filePath.string();
+        unit->name = getModuleName(file->filePath);
+        Preprocessor::mergeFiles(file, false, unit->sources);
+        const std::u8string& sourceCode = unit->sources.getMergedCode();
+        unit->sourceKey = BuildCache::computeKey(std::u8string(pathStr.begin(), pathStr.end()) + u8'\0' + sourceCode, {}, options);
+        m_units.push_back(std::move(unit));
+    }
+}
+
+bool ModuleCompiler::compile(std::vector<std::filesystem::path>* outObjectFiles) {
+    // Messages of units are collected and printed to output of this compilation (grouped by input file with -j)
+    std::ostream& output = ErrorHandler::getOutput();
+    std::ostream& log = ErrorHandler::getLogOutput();
+
+    // Unit sees only declarations of units before it, so it's key covers their interface and not their code: 
+    // when only body of included unit changes, only that unit is compiled again.
+    // Units are parsed in order, because struct types declared by previous units have to be known to parser.
+    // NOTE: Included units are parsed every time to get their interface, that's cheap compared to code generation
+    std::vector<std::u8string> knownStructs;
+    std::string interfacesKey; // hashes of interfaces of units before current one
+    bool isAnyOutdated = false;
+    for (size_t i = 0; i < m_units.size(); i++) {
+        ModuleUnit* unit = m_units[i].get();
+        const bool isMain = i + 1 == m_units.size();
+        const std::string keyInput = interfacesKey + '\0' + unit->sourceKey;
+        unit->cacheKey = BuildCache::computeKey(std::u8string(keyInput.begin(), keyInput.end()), {}, m_options);
+        unit->objectFilePath = m_objectDir / (unit->name + "-" + unit->cacheKey.substr(0, 16) + ".o");
+        std::error_code errorCode;
+        unit->isUpToDate = std::filesystem::exists(unit->objectFilePath, errorCode);
+        isAnyOutdated = isAnyOutdated || !unit->isUpToDate;
+        if (isMain && unit->isUpToDate) {
+            break; // interface of main unit isn't needed by any unit
+        }
+
+        llvm::TimeTraceScope scope("Parse module", unit->name);
+        const bool isParsed = parseUnit(unit, knownStructs, isMain, &knownStructs);
+        ErrorHandler::setOutput(&output);
+        ErrorHandler::setLogOutput(&log);
+        if (!isParsed) {
+            log << unit->log.str();
+            output << unit->diagnostics.str();
+            return false;
+        }
+
+        if (!isMain) {
+            const std::string interface = PrecompiledModule::serializeInterface(static_cast<const BlockAST*>(unit->tree.get()), getInitFunctionName(unit->name));
+            interfacesKey += utohexstr(xxh3_64bits(arrayRefFromStringRef(interface)), true, 16);
+        }
+    }
+
+    if (isAnyOutdated) {
+        std::error_code errorCode;
+        std::filesystem::create_directories(m_objectDir, errorCode);
+
+        Assembler::initializeTargets();
+
+        const bool timeTrace = llvm::timeTraceProfilerEnabled();
+        std::vector<char> results(m_units.size(), true);
+        {
+            llvm::DefaultThreadPool threadPool(llvm::hardware_concurrency(m_jobs));
+            for (size_t i = 0; i < m_units.size(); i++) {
+                if (m_units[i]->isUpToDate) {
+                    continue;
+                }
+                threadPool.async([&, i]() {
+                    if (timeTrace) {
+                        llvm::timeTraceProfilerInitialize(m_timeTraceGranularity, "lsc");
+                    }
+                    results[i] = compileUnit(i);
+                    ErrorHandler::setOutput(&std::cerr);
+                    ErrorHandler::setLogOutput(&std::cout);
+                    if (timeTrace) {
+                        llvm::timeTraceProfilerFinishThread();
+                    }
+                });
+            }
+            threadPool.wait();
+        }
+
+        bool success = true;
+        for (size_t i = 0; i < m_units.size(); i++) {
+            log << m_units[i]->log.str();
+            std::string unitDiagnostics = m_units[i]->diagnostics.str();
+            if (!unitDiagnostics.empty()) {
+                output << "In " << m_units[i]->file->filePath.string() << ":" << unitDiagnostics << std::endl;
+            }
+            success = success && results[i];
+        }
+        if (!success) {
+            return false;
+        }
+    }
+
+    for (const auto& unit : m_units) {
+        outObjectFiles->push_back(unit->objectFilePath);
+    }
+    return true;
+}
+
+bool ModuleCompiler::parseUnit(ModuleUnit* unit, const std::vector<std::u8string>& knownStructs, bool isMain, std::vector<std::u8string>* outStructs) {
+    ErrorHandler::reset();
+    ErrorHandler::setOutput(&unit->diagnostics);
+    ErrorHandler::setLogOutput(&unit->log);
+    ErrorHandler::init(unit->sources);
+
+    Lexer lexer = Lexer(unit->sources.getMergedCode());
+    TokenStream tokens = TokenStream(lexer, ErrorHandler::getLogOutput());
+    Parser parser = Parser(tokens);
+    if (!isMain) {
+        const std::string initFunctionName = getInitFunctionName(unit->name);
+        parser.setEntryFunctionName(std::u8string(initFunctionName.begin(), initFunctionName.end()));
+    }
+    for (const auto& structName : knownStructs) {
+        parser.addStructName(structName);
+    }
+    unit->tree = parser.parse();
+    *outStructs = parser.getStructNames();
+
+    return !ErrorHandler::hasError();
+}
+
+bool ModuleCompiler::compileUnit(size_t index) {
+    ModuleUnit* unit = m_units[index].get();
+    llvm::TimeTraceScope scope("Compile module", unit->name);
+
+    ErrorHandler::reset();
+    ErrorHandler::setOutput(&unit->diagnostics);
+    ErrorHandler::setLogOutput(&unit->log);
+    ErrorHandler::init(unit->sources);
+
+    IRGenerator codeGenerator = IRGenerator(unit->name.c_str(), unit->tree);
+    {
+        // NOTE: Errors in other units are reported by them, so declarations are generated silently
+        std::ostringstream ignoredDiagnostics;
+        ErrorHandler::setOutput(&ignoredDiagnostics);
+        for (size_t i = 0; i < index; i++) {
+            codeGenerator.generateInterface(m_units[i]->tree.get());
+        }
+        ErrorHandler::reset();
+        ErrorHandler::init(unit->sources);
+        ErrorHandler::setOutput(&unit->diagnostics);
+    }
+
+    const bool isMain = index + 1 == m_units.size();
+    if (isMain) {
+        codeGenerator.generateIRCode();
+    } else {
+        codeGenerator.generateModuleIRCode(getInitFunctionName(unit->name).c_str());
+    }
+
+    bool success = !ErrorHandler::hasError();
+    if (success) {
+        // Write to temporary file and rename it, so interrupted build never leaves broken object with valid name
+        std::filesystem::path tmpFilePath = unit->objectFilePath;
+        tmpFilePath += ".tmp";
+        Assembler assembler = Assembler(m_options);
+        success = assembler.compileToObjectFile(tmpFilePath, codeGenerator.getModule(), CodeGenFileType::ObjectFile);
+
+        std::error_code errorCode;
+        if (success) {
+            std::filesystem::rename(tmpFilePath, unit->objectFilePath, errorCode);
+            success = !errorCode;
+        } else {
+            std::filesystem::remove(tmpFilePath, errorCode);
+        }
+
+        // Objects of previous versions of this unit
+        for (const auto& entry : std::filesystem::directory_iterator(m_objectDir, errorCode)) {
+            const std::string fileName = entry.path().filename().string();
+            if (entry.path() != unit->objectFilePath && fileName.starts_with(unit->name + "-") && fileName.ends_with(".o")) {
+                std::filesystem::remove(entry.path(), errorCode);
+            }
+        }
+    }
+    return success;
+}
+
+std::string ModuleCompiler::getModuleName(const std::filesystem::path& filePath) {
+    // NOTE: Files with same name can be in different directories
+    const std::string pathStr = filePath.string();
+    return filePath.stem().string() + "_" + utohexstr(xxh3_64bits(arrayRefFromStringRef(pathStr)), true).substr(0, 8);
+}
+
+std::string ModuleCompiler::getInitFunctionName(const std::string& moduleName) {
+    return "__lorem_init_" + moduleName;
+}
+
+bool ModuleCompiler::emitPrecompiledModule(const Preprocessor& preprocessor, const std::filesystem::path& mainFilePath) {
+    std::optional<llvm::TimeTraceScope> phaseScope;
+    const std::string moduleName = getModuleName(mainFilePath);
+    const std::string initFunctionName = getInitFunctionName(moduleName);
+
+    phaseScope.emplace("Parse");
+    Lexer lexer = Lexer(preprocessor.getMergedSourceCode());
+    TokenStream tokens = TokenStream(lexer, ErrorHandler::getLogOutput());
+    Parser parser = Parser(tokens);
+    parser.setEntryFunctionName(std::u8string(initFunctionName.begin(), initFunctionName.end()));
+    std::unique_ptr<AST> tree = parser.parse();
+
+    if (ErrorHandler::hasError()) {
+        return false;
+    }
+
+    phaseScope.emplace("Generate IR");
+    IRGenerator codeGenerator = IRGenerator(moduleName.c_str(), tree);
+    codeGenerator.generateModuleIRCode(initFunctionName.c_str());
+
+    if (ErrorHandler::hasError()) {
+        return false;
+    }
+
+    // Main file is first, including files find module by it
+    phaseScope.emplace("Write module");
+    std::vector<std::pair<std::filesystem::path, std::u8string_view>> sourceFiles;
+    const auto units = preprocessor.getModuleUnits();
+    for (auto unit = units.rbegin(); unit != units.rend(); unit++) {
+        sourceFiles.emplace_back((*unit)->filePath, (*unit)->sourceCode);
+    }
+
+    const std::filesystem::path modulePath = PrecompiledModule::getModulePath(mainFilePath);
+    if (!PrecompiledModule::write(modulePath, sourceFiles, preprocessor.getLinkLibs(), static_cast<const BlockAST*>(tree.get()), initFunctionName, *codeGenerator.getModule())) {
+        ErrorHandler::logError(u8"Couldn't write precompiled module " + modulePath.u8string() + u8"!");
+        return false;
+    }
+    return true;
+}
@@ -1,16 +1,17 @@
 #include "Parser.hpp"
 
-Parser::Parser(const std::vector<Token>& tokens) 
+Parser::Parser(TokenStream& tokens) 
     : m_tokens(tokens)
     , m_currentToken(nullptr)
-    , m_ostr(std::cout)
+    , m_ostr(ErrorHandler::getLogOutput())
     , m_loopCount(0)
     , m_blockCount(-1)
     , m_isValid(true)
     , m_isTest(false)
-    , m_structHashMap() {}
+    , m_structHashMap()
+    , m_entryFunctionName(u8"main") {}
 
-Parser::Parser(const std::vector<Token>& tokens, bool isTest, std::ostream &ostr) 
+Parser::Parser(TokenStream& tokens, bool isTest, std::ostream &ostr) 
     : m_tokens(tokens)
     , m_currentToken(nullptr)
     , m_ostr(ostr)
@@ -18,7 +19,8 @@ Parser::Parser(const std::vector<Token>& tokens, bool isTest, std::ostream &ostr
     , m_blockCount(-1)
     , m_isValid(true)
     , m_isTest(isTest)
-    , m_structHashMap() {}
+    , m_structHashMap()
+    , m_entryFunctionName(u8"main") {}
 
 std::unique_ptr<BlockAST> Parser::parse() {
     if (m_isTest) {
@@ -28,18 +30,20 @@ std::unique_ptr<BlockAST> Parser::parse() {
 
     auto block = parseBlock();
 
-    // Create main wrapper function
-    std::unique_ptr<AST> pseudoReturnValue = std::make_unique<NumberAST>(0, currentLine);
-    auto pseudoReturn = std::make_unique<ReturnAST>(std::move(pseudoReturnValue), currentLine);
-
+    // Create main wrapper function (module initializer doesn't return anything)
+    const bool isMain = m_entryFunctionName == u8"main";
     auto pseudoBlockInstr = std::vector<std::unique_ptr<AST>>();
     pseudoBlockInstr.push_back(std::move(block));
-    pseudoBlockInstr.push_back(std::move(pseudoReturn));
+    if (isMain) {
+        std::unique_ptr<AST> pseudoReturnValue = std::make_unique<NumberAST>(0, currentLine);
+        auto pseudoReturn = std::make_unique<ReturnAST>(std::move(pseudoReturnValue), currentLine);
+        pseudoBlockInstr.push_back(std::move(pseudoReturn));
+    }
     auto pseudoBlock = std::make_unique<BlockAST>(std::move(pseudoBlockInstr), currentLine);
 
-    std::unique_ptr<IDataType> mainReturnType = std::make_unique<PrimitiveDataType>(PrimitiveType::INT);
+    std::unique_ptr<IDataType> mainReturnType = std::make_unique<PrimitiveDataType>(isMain ? PrimitiveType::INT : PrimitiveType::VOID);
     auto pseudoFunctionPrototype = std::make_unique<FunctionPrototypeAST>(
-        u8"main", 
+        m_entryFunctionName, 
         std::move(mainReturnType),
         std::vector<std::unique_ptr<TypeIdentifierPair>>(),
         true,
@@ -63,6 +67,23 @@ std::unique_ptr<BlockAST> Parser::parse() {
 }
 
 
+void Parser::setEntryFunctionName(const std::u8string& name) {
+    m_entryFunctionName = name;
+}
+
+void Parser::addStructName(const std::u8string& name) {
+    m_structHashMap.emplace(name, nullptr);
+}
+
+std::vector<std::u8string> Parser::getStructNames() const {
+    std::vector<std::u8string> names;
+    names.reserve(m_structHashMap.size());
+    for (const auto& entry : m_structHashMap) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
 bool Parser::isValid() {
     return m_isValid;
 }
@@ -79,16 +100,28 @@ bool Parser::isToken(TokenType type) {
     return m_currentToken->type == type;
 }
 
-bool Parser::isToken(const std::u8string_view& value) {
-    return m_currentToken->value == value;
+bool Parser::isToken(TokenKind kind) {
+    return m_currentToken->kind == kind;
 }
 
-bool Parser::isToken(TokenType type, const std::u8string_view& value) {
-    return m_currentToken->type == type && m_currentToken->value == value;
+bool Parser::isUnaryOperator() {
+    return isToken(TokenKind::PLUS) || isToken(TokenKind::MINUS) || isToken(TokenKind::NOT);
 }
 
-bool Parser::isUnaryOperator() {
-    return isToken(TokenType::OPERATOR, operators::PLUS) || isToken(TokenType::OPERATOR, operators::MINUS) || isToken(TokenType::OPERATOR, operators::NOT);
+bool Parser::isStructName() {
+    return isToken(TokenType::IDENTIFIER) && m_structHashMap.find(m_currentToken->value) != m_structHashMap.end();
+}
+
+/// @return false, if kind isn't a primitive type
+static bool toPrimitiveType(TokenKind kind, PrimitiveType* outType) {
+    switch (kind) {
+        case TokenKind::INT:  *outType = PrimitiveType::INT;  return true;
+        case TokenKind::LONG: *outType = PrimitiveType::LONG; return true;
+        case TokenKind::BOOL: *outType = PrimitiveType::BOOL; return true;
+        case TokenKind::CHAR: *outType = PrimitiveType::CHAR; return true;
+        case TokenKind::VOID: *outType = PrimitiveType::VOID; return true;
+        default: return false;
+    }
 }
 
 /**
@@ -102,27 +135,25 @@ bool Parser::isUnaryOperator() {
 */
 std::unique_ptr<IDataType> Parser::parseType() {
     std::unique_ptr<IDataType> basicType; // first part of the type without array part
-    std::unordered_map<std::u8string, StructDataType*>::iterator iter;
-    if ((iter = m_structHashMap.find(m_currentToken->value)) != m_structHashMap.end()) {
-        basicType = std::make_unique<StructDataType>(iter->first);
+    PrimitiveType primitiveType;
+    if (isStructName()) {
+        basicType = std::make_unique<StructDataType>(std::u8string(m_currentToken->value));
+    } else if (toPrimitiveType(m_currentToken->kind, &primitiveType)) {
+        basicType = std::make_unique<PrimitiveDataType>(primitiveType);
     } else {
-        auto typeIter = STR_TO_PRIMITIVE_MAP.find(m_currentToken->value);
-        if (typeIter == STR_TO_PRIMITIVE_MAP.end()) {
-            ErrorHandler::logError(u8"Unknown or invalid type!", currentLine);
-            return nullptr;
-        }
-        basicType = std::make_unique<PrimitiveDataType>(typeIter->second);
+        ErrorHandler::logError(u8"Unknown or invalid type!", currentLine);
+        return nullptr;
     }
     getNextToken(); // eat basic type
 
-    if (!isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_OPEN)) {
+    if (!isToken(TokenKind::SQR_BRACKET_OPEN)) {
         return basicType;
     }
 
     // That's array!
     // TODO(Vlad): 2D Arrays?
-    PrimitiveDataType* primitiveType = dynamic_cast<PrimitiveDataType*>(basicType.get());
-    if (primitiveType && primitiveType->type == PrimitiveType::VOID) {
+    PrimitiveDataType* primitiveDataType = dynamic_cast<PrimitiveDataType*>(basicType.get());
+    if (primitiveDataType && primitiveDataType->type == PrimitiveType::VOID) {
         ErrorHandler::logError(u8"Void type cannot be an array!", currentLine);
         return nullptr;
     }
@@ -140,7 +171,7 @@ std::unique_ptr<IDataType> Parser::parseType() {
         getNextToken(); // eat number
     }
 
-    if (!isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_CLOSE)) {
+    if (!isToken(TokenKind::SQR_BRACKET_CLOSE)) {
         ErrorHandler::logError(u8"Syntax Error: closing array bracket ']' expected!", currentLine);
         return nullptr;
     }
@@ -150,11 +181,10 @@ std::unique_ptr<IDataType> Parser::parseType() {
 
 const Token& Parser::getNextToken() {
     // Get first token
-    if (m_currentToken.base() == nullptr) {
-        m_currentToken = m_tokens.begin();
+    if (m_currentToken == nullptr) {
+        m_currentToken = &m_tokens.current();
         return *m_currentToken;
     }
-    m_currentToken++;
-    assert(m_currentToken != m_tokens.end());
+    m_currentToken = &m_tokens.advance();
     return *m_currentToken; 
 }
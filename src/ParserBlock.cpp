@@ -41,7 +41,7 @@ std::unique_ptr<BlockAST> Parser::parseBlock() {
 
 
     // Catch close/open more blocks than possible
-    if (isToken(TokenType::PUNCTUATION, punctuation::BLOCK_CLOSE)) {
+    if (isToken(TokenKind::BLOCK_CLOSE)) {
         m_blockCount--;
         
         lastOpenBlock.erase(lastOpenBlock.end());
@@ -62,12 +62,12 @@ std::unique_ptr<BlockAST> Parser::parseBlock() {
         m_isValid = false;
     }
 
-    if (isToken(TokenType::PUNCTUATION, punctuation::BLOCK_CLOSE)) 
+    if (isToken(TokenKind::BLOCK_CLOSE)) 
         getNextToken();
 
     return std::make_unique<BlockAST>(std::move(statements), currentLine);
 }
 
 bool Parser::isFinishedBlock() {
-    return isToken(TokenType::EOF_TOKEN) || isToken(TokenType::PUNCTUATION, punctuation::BLOCK_CLOSE);
+    return isToken(TokenType::EOF_TOKEN) || isToken(TokenKind::BLOCK_CLOSE);
 }
@@ -36,12 +36,12 @@ std::unique_ptr<AST> Parser::parseExpression() {
         return nullptr;
     }
 
-    if (isToken(TokenType::OPERATOR, operators::ASSIGN)) {
+    if (isToken(TokenKind::ASSIGN)) {
         ErrorHandler::logError(u8"Syntax Error: assign operator is not allowed here!", currentLine);
         return nullptr;
     }
 
-    auto op = *operators::BINARY_OPERATION_PRIORITY_MAP.find(m_currentToken->value);
+    Token op = *m_currentToken;
     getNextToken();
     
     auto right = parseExpressionSingle();
@@ -51,30 +51,30 @@ std::unique_ptr<AST> Parser::parseExpression() {
     }
 
     if (isExpressionEnd()) {
-        return std::make_unique<BinaryOperatorAST>(std::u8string(op.first), std::move(left), std::move(right), currentLine);
+        return std::make_unique<BinaryOperatorAST>(std::u8string(op.value), std::move(left), std::move(right), currentLine);
     }
 
     if (!isToken(TokenType::OPERATOR)) {
         ErrorHandler::logError(u8"Syntax Error: expected operator!", currentLine);
         return nullptr;
     }
-    if (isToken(TokenType::OPERATOR, operators::ASSIGN)) {
+    if (isToken(TokenKind::ASSIGN)) {
         ErrorHandler::logError(u8"Syntax Error: assign operator is not allowed here!", currentLine);
         return nullptr;
     }
-    auto nextOp = *operators::BINARY_OPERATION_PRIORITY_MAP.find(m_currentToken->value);
+    Token nextOp = *m_currentToken;
 
     getNextToken();
     auto nextExpression = parseExpression();
     if (nextExpression == nullptr) 
         return nullptr;
 
-    if (op.second <= nextOp.second) {
-        std::unique_ptr<AST> priorityOp = std::make_unique<BinaryOperatorAST>(std::u8string(op.first), std::move(left), std::move(right), currentLine);
-        return std::make_unique<BinaryOperatorAST>(std::u8string(nextOp.first), std::move(priorityOp), std::move(nextExpression), currentLine);
+    if (operators::getBinaryOperationPriority(op.kind) <= operators::getBinaryOperationPriority(nextOp.kind)) {
+        std::unique_ptr<AST> priorityOp = std::make_unique<BinaryOperatorAST>(std::u8string(op.value), std::move(left), std::move(right), currentLine);
+        return std::make_unique<BinaryOperatorAST>(std::u8string(nextOp.value), std::move(priorityOp), std::move(nextExpression), currentLine);
     } else {
-        std::unique_ptr<AST> priorityOp = std::make_unique<BinaryOperatorAST>(std::u8string(nextOp.first), std::move(right), std::move(nextExpression), currentLine);
-        return std::make_unique<BinaryOperatorAST>(std::u8string(op.first), std::move(left), std::move(priorityOp), currentLine);
+        std::unique_ptr<AST> priorityOp = std::make_unique<BinaryOperatorAST>(std::u8string(nextOp.value), std::move(right), std::move(nextExpression), currentLine);
+        return std::make_unique<BinaryOperatorAST>(std::u8string(op.value), std::move(left), std::move(priorityOp), currentLine);
     }
 }
 
@@ -100,7 +100,7 @@ std::unique_ptr<AST> Parser::parseExpression() {
 std::unique_ptr<AST> Parser::parseExpressionSingle() {
     if (isUnaryOperator()) {
         std::unique_ptr<AST> value;
-        std::u8string sign = m_currentToken->value;
+        Token sign = *m_currentToken;
 
         getNextToken();
         if (isUnaryOperator()) {
@@ -113,13 +113,13 @@ std::unique_ptr<AST> Parser::parseExpressionSingle() {
         if (value == nullptr)
             return nullptr;
 
-        if (sign == operators::PLUS || sign == operators::MINUS) {
+        if (sign.kind == TokenKind::PLUS || sign.kind == TokenKind::MINUS) {
             auto lhs = std::make_unique<NumberAST>(0, currentLine);
-            return std::make_unique<BinaryOperatorAST>(sign, std::move(lhs), std::move(value), currentLine);
-        } else if (sign == operators::NOT){
+            return std::make_unique<BinaryOperatorAST>(std::u8string(sign.value), std::move(lhs), std::move(value), currentLine);
+        } else if (sign.kind == TokenKind::NOT){
             // only left is important
             auto rhs = std::make_unique<NumberAST>(0, currentLine);
-            return std::make_unique<BinaryOperatorAST>(sign, std::move(value), std::move(rhs), currentLine);
+            return std::make_unique<BinaryOperatorAST>(std::u8string(sign.value), std::move(value), std::move(rhs), currentLine);
         }
 
         ErrorHandler::logError(u8"Syntax Error: invalid unary operator!", currentLine);
@@ -127,8 +127,13 @@ std::unique_ptr<AST> Parser::parseExpressionSingle() {
     }
 
     if (isToken(TokenType::NUMBER)) {
-        int intValue;
-        if (!toArabicConverter(m_currentToken->value, &intValue)) {
+        int64_t intValue;
+        RomanNumberError error = parseRomanNumber(m_currentToken->value, &intValue);
+        if (error == RomanNumberError::OUT_OF_RANGE) {
+            ErrorHandler::logError(u8"Syntax Error: Roman numeral is too big even for magnus!", currentLine);
+            return nullptr;
+        }
+        if (error != RomanNumberError::NONE) {
             ErrorHandler::logError(u8"Syntax Error: failure to understand Roman numeral, Optime vale!", currentLine);
             return nullptr;
         }
@@ -145,7 +150,8 @@ std::unique_ptr<AST> Parser::parseExpressionSingle() {
             }
         }
 
-        char8_t letter = m_currentToken->value[0];
+        // NOTE: Value is a view into source, empty literal ('') has no first character
+        char8_t letter = m_currentToken->value.empty() ? u8'\0' : m_currentToken->value[0];
 
         if(m_currentToken->value == u8"\\0") letter = '\0';
         else if(m_currentToken->value == u8"\\n") letter = '\n';
@@ -162,7 +168,7 @@ std::unique_ptr<AST> Parser::parseExpressionSingle() {
         for (size_t i = 0; i < m_currentToken->value.length(); i++) {
             char8_t letter = m_currentToken->value[i];
             if(letter == u8'\\') {
-                char8_t nextLetter = m_currentToken->value[i + 1];
+                char8_t nextLetter = i + 1 < m_currentToken->value.length() ? m_currentToken->value[i + 1] : u8'\0'; // backslash at the end
                 if (nextLetter == u8'n') letter = '\n';
                 else if (nextLetter == u8't') letter = '\t';
                 else if (nextLetter == u8'r') letter = '\r';
@@ -183,16 +189,16 @@ std::unique_ptr<AST> Parser::parseExpressionSingle() {
     }
 
     if (isToken(TokenType::BOOL)) {
-        bool state = m_currentToken->value == boolean_types::TRUE;
+        bool state = isToken(TokenKind::TRUE);
         getNextToken(); // eat bool
         return std::make_unique<BoolAST>(state, currentLine);
     } 
     if (isToken(TokenType::IDENTIFIER)) {
-        auto identifier = m_currentToken->value;
+        std::u8string identifier(m_currentToken->value);
         getNextToken(); // eat identifier
-        if (isToken(TokenType::PUNCTUATION, punctuation::PAREN_OPEN)) {
+        if (isToken(TokenKind::PAREN_OPEN)) {
             return parseExpressionFunctionCall(identifier);
-        } else if (isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_OPEN)) {
+        } else if (isToken(TokenKind::SQR_BRACKET_OPEN)) {
             getNextToken(); // eat [
 
             std::unique_ptr<AST> index = parseExpression();
@@ -201,7 +207,7 @@ std::unique_ptr<AST> Parser::parseExpressionSingle() {
                 return nullptr;
             }
 
-            if (!isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_CLOSE)) {
+            if (!isToken(TokenKind::SQR_BRACKET_CLOSE)) {
                 ErrorHandler::logError(u8"Syntax Error: closing array bracket ']' expected!", currentLine);
                 return nullptr;
             }
@@ -211,17 +217,17 @@ std::unique_ptr<AST> Parser::parseExpressionSingle() {
             return std::make_unique<VariableReferenceAST>(identifier, currentLine);
         }
     }
-    if (isToken(TokenType::PUNCTUATION, punctuation::PAREN_OPEN)) {
+    if (isToken(TokenKind::PAREN_OPEN)) {
         getNextToken();
         auto value = parseExpression();
-        if (!isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE)) {
+        if (!isToken(TokenKind::PAREN_CLOSE)) {
                 ErrorHandler::logError(u8"Syntax Error: closing array bracket ')' expected!", currentLine);
                 return nullptr;
             }
         getNextToken();
         return value;
     } 
-    if (isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_OPEN)) {
+    if (isToken(TokenKind::SQR_BRACKET_OPEN)) {
         return parseArray();
     }
 
@@ -241,7 +247,7 @@ std::unique_ptr<ArrayAST> Parser::parseArray() {
     getNextToken(); // eat '['
     std::vector<std::unique_ptr<AST>> elements;
     // get expression from each index
-    while (!isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_CLOSE)) { 
+    while (!isToken(TokenKind::SQR_BRACKET_CLOSE)) { 
         if (isToken(TokenType::EOF_TOKEN)) {
             ErrorHandler::logError(u8"Syntax Error: closing bracket for array initialization ']' expected!", currentLine);
             return nullptr;
@@ -255,11 +261,11 @@ std::unique_ptr<ArrayAST> Parser::parseArray() {
 
         elements.push_back(std::move(element));
 
-        if (isToken(TokenType::PUNCTUATION, punctuation::COMMA)) {
+        if (isToken(TokenKind::COMMA)) {
             getNextToken(); // eat ','
             continue;
         }
-        if (isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_CLOSE)) {
+        if (isToken(TokenKind::SQR_BRACKET_CLOSE)) {
             break;
         }
         ErrorHandler::logError(u8"Syntax Error: expected ',' or ']' during array initialization!", currentLine);
@@ -287,7 +293,7 @@ std::unique_ptr<FuncCallAST> Parser::parseExpressionFunctionCall(const std::u8st
     getNextToken();
 
     std::vector<std::unique_ptr<AST>> args;
-    while (!isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE)) {
+    while (!isToken(TokenKind::PAREN_CLOSE)) {
         auto expression = parseExpression();
         if (expression == nullptr) {
             ErrorHandler::logError(u8"Syntax Error: invalid expression inside function call!", currentLine);
@@ -296,15 +302,15 @@ std::unique_ptr<FuncCallAST> Parser::parseExpressionFunctionCall(const std::u8st
             
         args.push_back(std::move(expression));
 
-        if (isToken(TokenType::PUNCTUATION, punctuation::COMMA)) {
+        if (isToken(TokenKind::COMMA)) {
             getNextToken();
-            if (isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE)) {
+            if (isToken(TokenKind::PAREN_CLOSE)) {
                 ErrorHandler::logError(u8"Syntax Error: closing function call bracket ')' expected!", currentLine);
                 return nullptr;
             } 
             continue;
         }
-        if (isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE)) {
+        if (isToken(TokenKind::PAREN_CLOSE)) {
             break;
         }
 
@@ -14,9 +14,7 @@
  *      - var--
  */
 std::unique_ptr<AST> Parser::parseInstruction() {
-    bool isStructType = m_structHashMap.find(m_currentToken->value) != m_structHashMap.end();
-
-    if (isToken(TokenType::TYPE) || isStructType) {
+    if (isToken(TokenType::TYPE) || isStructName()) {
         std::unique_ptr<AST> declaration = parseInstructionDeclaration();
         if (declaration == nullptr) {
             ErrorHandler::logError(u8"Syntax Error: Invalid declaration!", currentLine);
@@ -49,15 +47,15 @@ std::unique_ptr<AST> Parser::parseInstruction() {
         }
     }
     if (isToken(TokenType::IDENTIFIER)) {
-        auto identifier = m_currentToken->value;
+        std::u8string identifier(m_currentToken->value);
         getNextToken();
 
-        if (isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_OPEN)) 
+        if (isToken(TokenKind::SQR_BRACKET_OPEN)) 
             return parseInstructionArrayAssignment(identifier);
-        if (isToken(TokenType::PUNCTUATION, punctuation::PAREN_OPEN)) 
+        if (isToken(TokenKind::PAREN_OPEN)) 
             return parseExpressionFunctionCall(identifier);
         if (isToken(TokenType::OPERATOR)) {
-            if (isToken(operators::ASSIGN)) 
+            if (isToken(TokenKind::ASSIGN)) 
                 return parseInstructionAssignment(identifier);
             else 
                 return parseInstructionShorthand(identifier);
@@ -102,13 +100,13 @@ std::unique_ptr<AST> Parser::parseInstructionArrayAssignment(const std::u8string
         return nullptr;
     }
 
-    if (!isToken(TokenType::PUNCTUATION, punctuation::SQR_BRACKET_CLOSE)) {
+    if (!isToken(TokenKind::SQR_BRACKET_CLOSE)) {
         ErrorHandler::logError(u8"Syntax Error: expected ']' after array indexing!", currentLine);
         return nullptr;
     }
     getNextToken(); // eat ']'
 
-    if (!isToken(TokenType::OPERATOR, operators::ASSIGN)) {
+    if (!isToken(TokenKind::ASSIGN)) {
         ErrorHandler::logError(u8"Syntax Error: assign operator '=' expected!", currentLine);
         return nullptr;
     }
@@ -137,12 +135,12 @@ std::unique_ptr<AST> Parser::parseInstructionArrayAssignment(const std::u8string
  *           ^ we are always here
  */
 std::unique_ptr<AST> Parser::parseInstructionShorthand(const std::u8string& identifier) {
-    if (!isToken(operators::PLUS) && !isToken(operators::MINUS) && !isToken(operators::MULTIPLY) && !isToken(operators::DIVIDE) && !isToken(operators::POWER)) {
+    if (!isToken(TokenKind::PLUS) && !isToken(TokenKind::MINUS) && !isToken(TokenKind::MULTIPLY) && !isToken(TokenKind::DIVIDE) && !isToken(TokenKind::POWER)) {
         ErrorHandler::logError(u8"Syntax Error: invalid shorthand operator - only plus, minus, multiply, divide and power is allowed!", currentLine);
         return nullptr;
     }
 
-    auto op = operators::BINARY_OPERATION_PRIORITY_MAP.find(m_currentToken->value);
+    Token op = *m_currentToken;
 
     getNextToken();
     if (!isToken(TokenType::OPERATOR)){
@@ -151,7 +149,7 @@ std::unique_ptr<AST> Parser::parseInstructionShorthand(const std::u8string& iden
     }
 
     std::unique_ptr<AST> expression;
-    if (op->first == m_currentToken->value && (op->first == operators::PLUS || op->first == operators::MINUS)) {
+    if (op.kind == m_currentToken->kind && (op.kind == TokenKind::PLUS || op.kind == TokenKind::MINUS)) {
         // var++ or var--
         getNextToken();
         expression = std::make_unique<NumberAST>(1, currentLine);
@@ -160,7 +158,7 @@ std::unique_ptr<AST> Parser::parseInstructionShorthand(const std::u8string& iden
             ErrorHandler::logError(u8"Syntax Error: shorthand operator cannot interact with other operators!", currentLine);  
             return nullptr;
         }
-    } else if (isToken(TokenType::OPERATOR, operators::ASSIGN)) {
+    } else if (isToken(TokenKind::ASSIGN)) {
 
         // var -= I
         getNextToken();
@@ -170,7 +168,7 @@ std::unique_ptr<AST> Parser::parseInstructionShorthand(const std::u8string& iden
         return nullptr;
     } 
 
-    std::unique_ptr<AST> rhs = std::make_unique<BinaryOperatorAST>(std::u8string(op->first), std::make_unique<VariableReferenceAST>(identifier, currentLine), std::move(expression), currentLine);
+    std::unique_ptr<AST> rhs = std::make_unique<BinaryOperatorAST>(std::u8string(op.value), std::make_unique<VariableReferenceAST>(identifier, currentLine), std::move(expression), currentLine);
     return std::make_unique<BinaryOperatorAST>(std::u8string(operators::ASSIGN), std::make_unique<VariableReferenceAST>(identifier, currentLine), std::move(rhs), currentLine);
 }
 
@@ -190,10 +188,10 @@ std::unique_ptr<AST> Parser::parseInstructionDeclarationStruct() {
         ErrorHandler::logError(u8"Syntax Error: identifier expected!", currentLine);
         return nullptr;
     }
-    std::u8string identifier = m_currentToken->value;
+    std::u8string identifier(m_currentToken->value);
     getNextToken(); // eat identifier
 
-    if (!isToken(TokenType::OPERATOR, u8"=")) {
+    if (!isToken(TokenKind::ASSIGN)) {
         ErrorHandler::logError(u8"Syntax Error: assign operator '=' expected!", currentLine);
         return nullptr;
     }
@@ -233,7 +231,7 @@ std::unique_ptr<AST> Parser::parseInstructionDeclarationStruct() {
  *      ^ we are always here
  */
 std::unique_ptr<AST> Parser::parseInstructionDeclaration() {
-    if (m_currentToken->value == types::STRUCT) {
+    if (isToken(TokenKind::STRUCT)) {
         return parseInstructionDeclarationStruct();
     }
     
@@ -245,14 +243,14 @@ std::unique_ptr<AST> Parser::parseInstructionDeclaration() {
         ErrorHandler::logError(u8"Syntax Error: identifier expected!", currentLine);
         return nullptr;
     }
-    std::u8string identifier = m_currentToken->value;
+    std::u8string identifier(m_currentToken->value);
     getNextToken(); // eat identifier
 
     if (isToken(TokenType::NEW_LINE) || isToken(TokenType::EOF_TOKEN)) {
         return std::make_unique<VariableDeclarationAST>(identifier, std::move(dataType), currentLine);
     }
     
-    if (!isToken(TokenType::OPERATOR, operators::ASSIGN)) {
+    if (!isToken(TokenKind::ASSIGN)) {
         ErrorHandler::logError(u8"Syntax Error: initialization missing! Use assign operator '=' to assign a value!", currentLine);
         return nullptr;
     }
@@ -261,7 +259,7 @@ std::unique_ptr<AST> Parser::parseInstructionDeclaration() {
     std::unique_ptr<AST> expression;
 
     // λ
-    if (isToken(TokenType::KEYWORD, keywords::FUNCTION)) { 
+    if (isToken(TokenKind::FUNCTION)) { 
         return parseInstructionFunction(identifier, std::move(dataType));
     }
 
@@ -288,7 +286,7 @@ std::unique_ptr<AST> Parser::parseInstructionDeclaration() {
 std::unique_ptr<FunctionPrototypeAST> Parser::parseInstructionPrototype(const std::u8string& identifier, std::unique_ptr<IDataType> type) {
     getNextToken(); // eat '('
     std::vector<std::unique_ptr<TypeIdentifierPair>> args;
-    while (!isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE) && !isToken(TokenType::EOF_TOKEN)) {
+    while (!isToken(TokenKind::PAREN_CLOSE) && !isToken(TokenType::EOF_TOKEN)) {
         std::unique_ptr<IDataType> dataType = parseType();
         if (!dataType) {
             return nullptr;
@@ -300,21 +298,21 @@ std::unique_ptr<FunctionPrototypeAST> Parser::parseInstructionPrototype(const st
             return nullptr;
         }
 
-        std::u8string identifier = m_currentToken->value;
+        std::u8string identifier(m_currentToken->value);
         getNextToken(); // eat identifier
         
         args.emplace_back(std::make_unique<TypeIdentifierPair>(std::move(dataType), identifier));
 
-        if (isToken(TokenType::PUNCTUATION, punctuation::COMMA)) {
+        if (isToken(TokenKind::COMMA)) {
             getNextToken();
-            if (isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE) || isToken(TokenType::EOF_TOKEN)) {
+            if (isToken(TokenKind::PAREN_CLOSE) || isToken(TokenType::EOF_TOKEN)) {
                 ErrorHandler::logError(u8"Syntax Error: missing expression after comma!", currentLine);
                 return nullptr;
             }
 
             continue;
         }
-        if (isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE)) {
+        if (isToken(TokenKind::PAREN_CLOSE)) {
             break;
         }
 
@@ -322,7 +320,7 @@ std::unique_ptr<FunctionPrototypeAST> Parser::parseInstructionPrototype(const st
         return nullptr;
     }
 
-    if(!isToken(TokenType::PUNCTUATION, u8")")) {
+    if(!isToken(TokenKind::PAREN_CLOSE)) {
         ErrorHandler::logError(u8"Syntax Error: expected ')' in function declaration!", currentLine);
         return nullptr;
     }
@@ -334,7 +332,7 @@ std::unique_ptr<FunctionPrototypeAST> Parser::parseInstructionPrototype(const st
         getNextToken();
     }
 
-    bool isDefined = isToken(TokenType::PUNCTUATION, punctuation::BLOCK_OPEN);
+    bool isDefined = isToken(TokenKind::BLOCK_OPEN);
     return std::make_unique<FunctionPrototypeAST>(identifier, std::move(type), std::move(args), isDefined, currentLine);
 }
 
@@ -356,7 +354,7 @@ std::unique_ptr<AST> Parser::parseInstructionFunction(const std::u8string& ident
     }
 
     getNextToken(); // eat λ
-    if (!isToken(TokenType::PUNCTUATION, punctuation::PAREN_OPEN)) {
+    if (!isToken(TokenKind::PAREN_OPEN)) {
         ErrorHandler::logError(u8"Syntax Error: opening bracket '(' expected!", currentLine);
         return nullptr;
     }
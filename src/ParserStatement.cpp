@@ -36,7 +36,7 @@ std::unique_ptr<AST> Parser::parseStatement() {
  *  - ∑(∞): ... ;
  */
 std::unique_ptr<AST> Parser::parseStatementFlow() {
-    if (isToken(keywords::BREAK)) {
+    if (isToken(TokenKind::BREAK)) {
         if (m_loopCount == 0) {
             ErrorHandler::logError(u8"Syntax Error: finio can only be called inside of a loop", currentLine);
             return nullptr;
@@ -46,13 +46,13 @@ std::unique_ptr<AST> Parser::parseStatementFlow() {
         return std::make_unique<BreakAST>(currentLine);
     }
 
-    if (isToken(keywords::RETURN)) {
+    if (isToken(TokenKind::RETURN)) {
         getNextToken();
         return std::make_unique<ReturnAST>(parseExpression(), currentLine);
     }
-    if (isToken(keywords::IF)) 
+    if (isToken(TokenKind::IF)) 
         return parseStatementBranching();
-    if (isToken(keywords::FOR_LOOP)) 
+    if (isToken(TokenKind::FOR_LOOP)) 
         return parseStatementLooping();
     
     ErrorHandler::logError(u8"Syntax Error: Invalid flow keyword!", currentLine);
@@ -86,7 +86,7 @@ std::unique_ptr<IfAST> Parser::parseStatementBranching() {
         currentLine++;
         getNextToken();
     }
-    if (!isToken(TokenType::PUNCTUATION, punctuation::BLOCK_OPEN)) {
+    if (!isToken(TokenKind::BLOCK_OPEN)) {
         ErrorHandler::logError(u8"Syntax Error: opening bracket ':' expected!", currentLine);
         return nullptr;
     }
@@ -103,7 +103,7 @@ std::unique_ptr<IfAST> Parser::parseStatementBranching() {
         getNextToken();
     }
 
-    if (isToken(TokenType::KEYWORD, keywords::ELIF)) {
+    if (isToken(TokenKind::ELIF)) {
         auto pseudoIf = std::vector<std::unique_ptr<AST>>();
         auto elifBranch = parseStatementBranching();
         if (elifBranch == nullptr) {
@@ -112,14 +112,14 @@ std::unique_ptr<IfAST> Parser::parseStatementBranching() {
         }
         pseudoIf.emplace_back(std::move(elifBranch));
         elseBlock = std::make_unique<BlockAST>(std::move(pseudoIf), currentLine);
-    } else if (isToken(TokenType::KEYWORD, keywords::ELSE)) {
+    } else if (isToken(TokenKind::ELSE)) {
         getNextToken();
 
         while (isToken(TokenType::NEW_LINE)){
             currentLine++;
             getNextToken();
         }
-        if (!isToken(TokenType::PUNCTUATION, punctuation::BLOCK_OPEN)) {
+        if (!isToken(TokenKind::BLOCK_OPEN)) {
             ErrorHandler::logError(u8"Syntax Error: closing bracket ';' expected!", currentLine);
             return nullptr;
         } 
@@ -155,7 +155,7 @@ std::unique_ptr<IfAST> Parser::parseStatementBranching() {
  */
 std::unique_ptr<AST> Parser::parseStatementLooping() {
     getNextToken();
-    if (!isToken(TokenType::PUNCTUATION, punctuation::PAREN_OPEN)) {
+    if (!isToken(TokenKind::PAREN_OPEN)) {
         ErrorHandler::logError(u8"Syntax Error: opening bracket '(' expected!", currentLine);
         return nullptr;
     }
@@ -169,17 +169,17 @@ std::unique_ptr<AST> Parser::parseStatementLooping() {
                 ErrorHandler::logError(u8"Syntax Error: Invalid loop declaration!", currentLine);
                 return nullptr;
             }
-        if (isToken(TokenType::PUNCTUATION, punctuation::COMMA)) getNextToken();
+        if (isToken(TokenKind::COMMA)) getNextToken();
     }
 
-    if (!isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE)) {
+    if (!isToken(TokenKind::PAREN_CLOSE)) {
         endExpression = parseExpression();
         if (endExpression == nullptr){ 
             ErrorHandler::logError(u8"Syntax Error: closing bracket ')' is expected!", currentLine);
             return nullptr;
         }
 
-        if (isToken(TokenType::PUNCTUATION, punctuation::COMMA)) {
+        if (isToken(TokenKind::COMMA)) {
             getNextToken();
             if (isToken(TokenType::TYPE)) {
                 ErrorHandler::logError(u8"Syntax Error: type declaration must be at first position of loop!", currentLine);
@@ -192,7 +192,7 @@ std::unique_ptr<AST> Parser::parseStatementLooping() {
             }
         }
 
-        if (!isToken(TokenType::PUNCTUATION, punctuation::PAREN_CLOSE)) {
+        if (!isToken(TokenKind::PAREN_CLOSE)) {
             ErrorHandler::logError(u8"Syntax Error: closing bracket not expected!", currentLine);
             return nullptr;
         }
@@ -203,7 +203,7 @@ std::unique_ptr<AST> Parser::parseStatementLooping() {
         currentLine++;
         getNextToken();
     }
-    if (!isToken(TokenType::PUNCTUATION, punctuation::BLOCK_OPEN)){ 
+    if (!isToken(TokenKind::BLOCK_OPEN)){ 
         ErrorHandler::logError(u8"Syntax Error: opening bracket ':' expected!", currentLine);
         return nullptr;
     }
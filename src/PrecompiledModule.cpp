@@ -0,0 +1,410 @@
+#include "PrecompiledModule.hpp"
+#include "Version.hpp"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/xxhash.h"
+#include "llvm/Support/raw_ostream.h"
+
+// Layout of .lmod file (numbers are little endian, strings are prefixed with their u32 size):
+//   magic, compiler build (see getCompilerIdentity), u64 hash of everything after it (damaged module isn't used)
+//   source files (path, u64 hash), link libraries (path)
+//   interface: u32 count of declarations, every declaration starts with DeclarationKind
+//   u64 size of bitcode, bitcode (aligned to 4 bytes) until end of file
+static constexpr llvm::StringLiteral MAGIC = "LMOD";
+static constexpr size_t NO_LINE = size_t(-1); // declarations of interface aren't in any source line
+static constexpr unsigned MAX_TYPE_DEPTH = 64; // damaged file must not overflow stack
+
+enum class DeclarationKind : uint8_t {
+    STRUCT, GLOBAL, FUNCTION
+};
+
+enum class TypeKind : uint8_t {
+    PRIMITIVE, ARRAY, STRUCT
+};
+
+// Reads parts of module one after another, after first read out of bounds every read fails
+class ModuleReader {
+private:
+    llvm::StringRef m_data;
+    size_t m_position;
+    bool m_isValid;
+
+public:
+    ModuleReader(llvm::StringRef data)
+        : m_data(data)
+        , m_position(0)
+        , m_isValid(true) {}
+
+    llvm::StringRef readBytes(uint64_t size) {
+        if (!m_isValid || size > m_data.size() - m_position) {
+            m_isValid = false;
+            return llvm::StringRef();
+        }
+        llvm::StringRef bytes = m_data.substr(m_position, size);
+        m_position += size;
+        return bytes;
+    }
+
+    uint8_t readU8() {
+        llvm::StringRef bytes = readBytes(1);
+        return m_isValid ? bytes[0] : 0;
+    }
+
+    uint32_t readU32() {
+        llvm::StringRef bytes = readBytes(4);
+        return m_isValid ? llvm::support::endian::read32le(bytes.data()) : 0;
+    }
+
+    uint64_t readU64() {
+        llvm::StringRef bytes = readBytes(8);
+        return m_isValid ? llvm::support::endian::read64le(bytes.data()) : 0;
+    }
+
+    llvm::StringRef readString() {
+        return readBytes(readU32());
+    }
+
+    void alignTo(size_t alignment) {
+        readBytes(llvm::alignTo(m_position, alignment) - m_position);
+    }
+
+    bool isValid() const {
+        return m_isValid;
+    }
+
+    size_t getPosition() const {
+        return m_position;
+    }
+};
+
+static void writeU32(std::string& out, uint32_t value) {
+    char bytes[4];
+    llvm::support::endian::write32le(bytes, value);
+    out.append(bytes, sizeof(bytes));
+}
+
+static void writeU64(std::string& out, uint64_t value) {
+    char bytes[8];
+    llvm::support::endian::write64le(bytes, value);
+    out.append(bytes, sizeof(bytes));
+}
+
+static void writeString(std::string& out, llvm::StringRef str) {
+    writeU32(out, str.size());
+    out.append(str.data(), str.size());
+}
+
+static void writeString(std::string& out, const std::u8string& str) {
+    writeString(out, llvm::StringRef((const char*)str.data(), str.size()));
+}
+
+static std::u8string toU8String(llvm::StringRef str) {
+    return std::u8string((const char8_t*)str.data(), str.size());
+}
+
+static void writeType(std::string& out, const IDataType* type) {
+    if (auto primitiveType = dynamic_cast<const PrimitiveDataType*>(type)) {
+        out += static_cast<char>(TypeKind::PRIMITIVE);
+        out += static_cast<char>(primitiveType->type);
+    } else if (auto arrayType = dynamic_cast<const ArrayDataType*>(type)) {
+        out += static_cast<char>(TypeKind::ARRAY);
+        writeU64(out, arrayType->size);
+        writeType(out, arrayType->elementType.get());
+    } else {
+        // NOTE: Struct is written with it's attributes only where it's declared, elsewhere it has none
+        auto structType = static_cast<const StructDataType*>(type);
+        out += static_cast<char>(TypeKind::STRUCT);
+        writeString(out, structType->name);
+        writeU32(out, structType->attributes.size());
+        for (const auto& attribute : structType->attributes) {
+            writeType(out, attribute.type.get());
+            writeString(out, attribute.identifier);
+        }
+    }
+}
+
+static std::unique_ptr<IDataType> readType(ModuleReader& reader, unsigned depth);
+
+static std::unique_ptr<StructDataType> readStructType(ModuleReader& reader, unsigned depth) {
+    std::u8string name = toU8String(reader.readString());
+    std::vector<TypeIdentifierPair> attributes;
+    const uint32_t attributeCount = reader.readU32();
+    for (uint32_t i = 0; i < attributeCount && reader.isValid(); i++) {
+        std::unique_ptr<IDataType> type = readType(reader, depth + 1);
+        if (!type) {
+            return nullptr;
+        }
+        attributes.emplace_back(std::move(type), toU8String(reader.readString()));
+    }
+    return std::make_unique<StructDataType>(name, std::move(attributes));
+}
+
+static std::unique_ptr<IDataType> readType(ModuleReader& reader, unsigned depth) {
+    if (depth > MAX_TYPE_DEPTH) {
+        return nullptr;
+    }
+    switch (static_cast<TypeKind>(reader.readU8())) {
+        case TypeKind::PRIMITIVE: {
+            const uint8_t primitiveType = reader.readU8();
+            if (primitiveType > static_cast<uint8_t>(PrimitiveType::VOID)) {
+                return nullptr;
+            }
+            return std::make_unique<PrimitiveDataType>(static_cast<PrimitiveType>(primitiveType));
+        }
+        case TypeKind::ARRAY: {
+            const uint64_t size = reader.readU64();
+            std::unique_ptr<IDataType> elementType = readType(reader, depth + 1);
+            if (!elementType) {
+                return nullptr;
+            }
+            return std::make_unique<ArrayDataType>(std::move(elementType), size);
+        }
+        case TypeKind::STRUCT:
+            return readStructType(reader, depth);
+    }
+    return nullptr;
+}
+
+static void writeDeclarations(std::string& out, const BlockAST* root, const std::string& initFunctionName) {
+    std::string declarations;
+    uint32_t declarationCount = 0;
+    for (const auto& instruction : root->getInstructions()) {
+        if (auto structAST = dynamic_cast<const StructAST*>(instruction.get())) {
+            declarations += static_cast<char>(DeclarationKind::STRUCT);
+            writeType(declarations, structAST->getStructType());
+        } else if (auto variable = dynamic_cast<const VariableDeclarationAST*>(instruction.get())) {
+            declarations += static_cast<char>(DeclarationKind::GLOBAL);
+            writeString(declarations, variable->getName());
+            writeType(declarations, variable->getDataType());
+        } else {
+            // function with body or prototype of extern function
+            auto function = dynamic_cast<const FunctionAST*>(instruction.get());
+            auto prototype = function ? function->getPrototype() : dynamic_cast<const FunctionPrototypeAST*>(instruction.get());
+            if (!prototype || prototype->getName() == std::u8string(initFunctionName.begin(), initFunctionName.end())) {
+                continue;
+            }
+            declarations += static_cast<char>(DeclarationKind::FUNCTION);
+            declarations += static_cast<char>(function != nullptr);
+            writeString(declarations, prototype->getName());
+            writeType(declarations, prototype->getReturnType());
+            writeU32(declarations, prototype->getArgs().size());
+            for (const auto& arg : prototype->getArgs()) {
+                writeType(declarations, arg->type.get());
+                writeString(declarations, arg->identifier);
+            }
+        }
+        declarationCount++;
+    }
+    writeU32(out, declarationCount);
+    out += declarations;
+}
+
+static std::unique_ptr<AST> readDeclaration(ModuleReader& reader, std::vector<std::u8string>& outStructNames) {
+    switch (static_cast<DeclarationKind>(reader.readU8())) {
+        case DeclarationKind::STRUCT: {
+            if (static_cast<TypeKind>(reader.readU8()) != TypeKind::STRUCT) {
+                return nullptr;
+            }
+            std::unique_ptr<StructDataType> type = readStructType(reader, 0);
+            if (!type) {
+                return nullptr;
+            }
+            outStructNames.push_back(type->name);
+            return std::make_unique<StructAST>(std::move(type), NO_LINE);
+        }
+        case DeclarationKind::GLOBAL: {
+            std::u8string name = toU8String(reader.readString());
+            std::unique_ptr<IDataType> type = readType(reader, 0);
+            if (!type) {
+                return nullptr;
+            }
+            return std::make_unique<VariableDeclarationAST>(name, std::move(type), NO_LINE);
+        }
+        case DeclarationKind::FUNCTION: {
+            // NOTE: Functions with body are declared as defined, they pass their result by return argument
+            const bool isDefined = reader.readU8() != 0;
+            std::u8string name = toU8String(reader.readString());
+            std::unique_ptr<IDataType> returnType = readType(reader, 0);
+            if (!returnType) {
+                return nullptr;
+            }
+            std::vector<std::unique_ptr<TypeIdentifierPair>> args;
+            const uint32_t argCount = reader.readU32();
+            for (uint32_t i = 0; i < argCount && reader.isValid(); i++) {
+                std::unique_ptr<IDataType> type = readType(reader, 0);
+                if (!type) {
+                    return nullptr;
+                }
+                args.push_back(std::make_unique<TypeIdentifierPair>(std::move(type), toU8String(reader.readString())));
+            }
+            return std::make_unique<FunctionPrototypeAST>(name, std::move(returnType), std::move(args), isDefined, NO_LINE);
+        }
+    }
+    return nullptr;
+}
+
+PrecompiledModule::PrecompiledModule()
+    : m_filePath()
+    , m_buffer(nullptr)
+    , m_sourceFiles()
+    , m_linkLibraries()
+    , m_interface(nullptr)
+    , m_structNames()
+    , m_bitcode() {}
+
+std::filesystem::path PrecompiledModule::getModulePath(const std::filesystem::path& sourceFilePath) {
+    std::filesystem::path modulePath = sourceFilePath;
+    modulePath.replace_extension(FILE_EXTENSION);
+    return modulePath;
+}
+
+uint64_t PrecompiledModule::hashSourceFile(llvm::StringRef sourceCode) {
+    return llvm::xxh3_64bits(llvm::arrayRefFromStringRef(sourceCode));
+}
+
+std::string PrecompiledModule::serializeInterface(const BlockAST* root, const std::string& initFunctionName) {
+    std::string interface;
+    writeDeclarations(interface, root, initFunctionName);
+    return interface;
+}
+
+std::unique_ptr<PrecompiledModule> PrecompiledModule::load(const std::filesystem::path& filePath) {
+    auto buffer = llvm::MemoryBuffer::getFile(filePath.string(), false, false);
+    if (!buffer) {
+        return nullptr;
+    }
+    llvm::TimeTraceScope scope("Load module", [&]() { return filePath.string(); });
+
+    std::unique_ptr<PrecompiledModule> module = std::unique_ptr<PrecompiledModule>(new PrecompiledModule());
+    module->m_filePath = filePath;
+    module->m_buffer = std::move(*buffer);
+
+    ModuleReader reader = ModuleReader(module->m_buffer->getBuffer());
+    if (reader.readBytes(MAGIC.size()) != MAGIC || reader.readString() != getCompilerIdentity()) {
+        return nullptr;
+    }
+    const uint64_t hash = reader.readU64();
+    if (!reader.isValid() || llvm::xxh3_64bits(llvm::arrayRefFromStringRef(module->m_buffer->getBuffer().drop_front(reader.getPosition()))) != hash) {
+        return nullptr;
+    }
+
+    const uint32_t sourceFileCount = reader.readU32();
+    for (uint32_t i = 0; i < sourceFileCount && reader.isValid(); i++) {
+        std::filesystem::path sourceFilePath = reader.readString().str();
+        module->m_sourceFiles.emplace_back(std::move(sourceFilePath), reader.readU64());
+    }
+    const uint32_t linkLibraryCount = reader.readU32();
+    for (uint32_t i = 0; i < linkLibraryCount && reader.isValid(); i++) {
+        module->m_linkLibraries.emplace_back(reader.readString().str());
+    }
+
+    std::vector<std::unique_ptr<AST>> declarations;
+    const uint32_t declarationCount = reader.readU32();
+    for (uint32_t i = 0; i < declarationCount && reader.isValid(); i++) {
+        std::unique_ptr<AST> declaration = readDeclaration(reader, module->m_structNames);
+        if (!declaration) {
+            return nullptr;
+        }
+        declarations.push_back(std::move(declaration));
+    }
+    module->m_interface = std::make_unique<BlockAST>(std::move(declarations), NO_LINE);
+
+    const uint64_t bitcodeSize = reader.readU64();
+    reader.alignTo(4);
+    module->m_bitcode = reader.readBytes(bitcodeSize);
+    if (!reader.isValid() || module->m_sourceFiles.empty()) {
+        return nullptr;
+    }
+    return module;
+}
+
+bool PrecompiledModule::write(
+    const std::filesystem::path& filePath,
+    const std::vector<std::pair<std::filesystem::path, std::u8string_view>>& sourceFiles,
+    const std::vector<std::filesystem::path>& linkLibraries,
+    const BlockAST* root,
+    const std::string& initFunctionName,
+    const llvm::Module& module
+) {
+    llvm::TimeTraceScope scope("Write module", filePath.string());
+
+    std::string header;
+    header.append(MAGIC.data(), MAGIC.size());
+    writeString(header, getCompilerIdentity());
+    const size_t headerSize = header.size() + 8; // hash of content is appended to header
+
+    std::string content;
+
+    writeU32(content, sourceFiles.size());
+    for (const auto& [sourceFilePath, sourceCode] : sourceFiles) {
+        writeString(content, sourceFilePath.string());
+        writeU64(content, hashSourceFile(llvm::StringRef((const char*)sourceCode.data(), sourceCode.size())));
+    }
+    writeU32(content, linkLibraries.size());
+    for (const auto& library : linkLibraries) {
+        writeString(content, library.string());
+    }
+
+    writeDeclarations(content, root, initFunctionName);
+
+    llvm::SmallVector<char, 0> bitcode;
+    {
+        llvm::raw_svector_ostream bitcodeStream(bitcode);
+        llvm::WriteBitcodeToFile(module, bitcodeStream);
+    }
+    writeU64(content, bitcode.size());
+    content.resize(llvm::alignTo(headerSize + content.size(), 4) - headerSize, '\0');
+    content.append(bitcode.data(), bitcode.size());
+    writeU64(header, llvm::xxh3_64bits(llvm::arrayRefFromStringRef(content)));
+
+    // Write to unique temporary file and rename it, so interrupted or concurrent build never leaves broken module with valid name
+    std::filesystem::path tmpFilePattern = filePath;
+    tmpFilePattern += ".tmp-%%%%%%%%";
+    int fileDescriptor;
+    llvm::SmallString<128> tmpFilePath;
+    if (llvm::sys::fs::createUniqueFile(tmpFilePattern.string(), fileDescriptor, tmpFilePath)) {
+        return false;
+    }
+    {
+        llvm::raw_fd_ostream file(fileDescriptor, true);
+        file << header << content;
+        file.close();
+        if (file.has_error()) {
+            file.clear_error();
+            llvm::sys::fs::remove(tmpFilePath);
+            return false;
+        }
+    }
+    if (llvm::sys::fs::rename(tmpFilePath, filePath.string())) {
+        llvm::sys::fs::remove(tmpFilePath);
+        return false;
+    }
+    return true;
+}
+
+const std::filesystem::path& PrecompiledModule::getFilePath() const {
+    return m_filePath;
+}
+
+const std::vector<std::pair<std::filesystem::path, uint64_t>>& PrecompiledModule::getSourceFiles() const {
+    return m_sourceFiles;
+}
+
+const std::vector<std::filesystem::path>& PrecompiledModule::getLinkLibraries() const {
+    return m_linkLibraries;
+}
+
+BlockAST* PrecompiledModule::getInterface() const {
+    return m_interface.get();
+}
+
+const std::vector<std::u8string>& PrecompiledModule::getStructNames() const {
+    return m_structNames;
+}
+
+llvm::MemoryBufferRef PrecompiledModule::getBitcode() const {
+    return llvm::MemoryBufferRef(m_bitcode, m_buffer->getBufferIdentifier());
+}
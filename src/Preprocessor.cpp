@@ -1,37 +1,34 @@
 #include "Preprocessor.hpp"
+#include "llvm/Support/TimeProfiler.h"
 
-Preprocessor::Preprocessor(std::filesystem::path& mainFilePath)
+Preprocessor::Preprocessor(const std::filesystem::path& mainFilePath, bool onlyResolveIncludes, bool usePrecompiledModules)
     : m_rootFile(nullptr)
     , m_includedFiles()
+    , m_includedFileSet()
     , m_linkLibraries()
-    , m_mergedLines()
+    , m_usePrecompiledModules(usePrecompiledModules)
+    , m_precompiledModules()
+    , m_sources()
 {    
-    std::vector<std::filesystem::path> stack;
-    m_rootFile = createFileTree(mainFilePath, stack);
-    m_mergedLines = mergeFiles(m_rootFile.get());
+    ScannedFileMap scannedFiles = discoverFiles(mainFilePath);
+    std::unordered_set<std::string> includingFiles;
+    m_rootFile = createFileTree(mainFilePath, scannedFiles, includingFiles);
+    if (!onlyResolveIncludes) {
+        mergeFiles(m_rootFile.get(), true, m_sources);
+    }
 }
 
-const std::vector<SourceLine>& Preprocessor::getMergedLines() const {
-    return m_mergedLines;
+const SourceManager& Preprocessor::getSourceManager() const {
+    return m_sources;
 }
 
-std::u8string Preprocessor::getMergedSourceCode() const {
-    std::u8string mergedCode = u8"";
-    for (const auto& line : m_mergedLines) {
-        mergedCode += line.line;
-    }
-
-    // For debugging purposes, print the merged lines
-    // for(size_t i = 0; i < m_mergedLines.size(); i++) {
-    //     std::cout   << "Line " << i + 1 
-    //                 << " Merged Line " << m_mergedLines[i].lineIndexInFile + 1 
-    //                 << " in file " << m_mergedLines[i].filePath.filename() << ": " 
-    //                 << (const char*)m_mergedLines[i].line.c_str() << std::endl;
-    // } 
+const std::u8string& Preprocessor::getMergedSourceCode() const {
+    const std::u8string& mergedCode = m_sources.getMergedCode();
 
     #if !defined(NDEBUG)
-    std::cout << "----------------------- Source Code: ----------------------- " << std::endl << std::endl;
-    std::cout << (const char*)(mergedCode.c_str()) << std::endl << std::endl;
+    std::ostream& log = ErrorHandler::getLogOutput();
+    log << "----------------------- Source Code: ----------------------- " << std::endl << std::endl;
+    log << (const char*)(mergedCode.c_str()) << std::endl << std::endl;
     #endif
 
     return mergedCode;
@@ -41,32 +38,126 @@ const std::vector<std::filesystem::path>& Preprocessor::getLinkLibs() const {
     return m_linkLibraries;
 }
 
-std::unique_ptr<LoremSourceFile> Preprocessor::createFileTree(std::filesystem::path& filePath, std::vector<std::filesystem::path>& includingStack) {
-    includingStack.push_back(filePath);
-    m_includedFiles.emplace_back(filePath);
+const std::vector<std::unique_ptr<PrecompiledModule>>& Preprocessor::getPrecompiledModules() const {
+    return m_precompiledModules;
+}
+
+const std::vector<std::filesystem::path>& Preprocessor::getIncludedFiles() const {
+    return m_includedFiles;
+}
+
+void Preprocessor::writeDependencies(std::ostream& ostr, const std::filesystem::path& target) const {
+    ostr << escapeMakefilePath(target) << ":";
+    for (const auto& includedFile : m_includedFiles) {
+        ostr << " \\\n  " << escapeMakefilePath(includedFile);
+    }
+    ostr << "\n";
+
+    // main file is first, it isn't included
+    for (size_t i = 1; i < m_includedFiles.size(); i++) {
+        ostr << "\n" << escapeMakefilePath(m_includedFiles[i]) << ":\n";
+    }
+}
+
+std::string Preprocessor::escapeMakefilePath(const std::filesystem::path& path) {
+    std::string escaped;
+    for (char character : path.string()) {
+        if (character == ' ' || character == '#') {
+            escaped += '\\';
+        } else if (character == '$') {
+            escaped += '$';
+        }
+        escaped += character;
+    }
+    return escaped;
+}
+
+void Preprocessor::enableFileCache(bool enable) {
+    std::lock_guard<std::mutex> lock(s_fileCacheMutex);
+    s_fileCacheEnabled = enable;
+    if (!enable) {
+        s_fileCache.clear();
+    }
+}
+
+void Preprocessor::setReadThreads(unsigned threads) {
+    s_readThreads = threads;
+}
+
+// Files, which are read at the moment or were read
+struct Preprocessor::Discovery {
+    std::mutex mutex;
+    ScannedFileMap scannedFiles; // file is in map (nullptr) as soon as somebody reads it
+    std::optional<llvm::DefaultThreadPool> threadPool; // created when first file has more than one include
+};
+
+ScannedFileMap Preprocessor::discoverFiles(const std::filesystem::path& mainFilePath) {
+    llvm::TimeTraceScope scope("Read files");
+    Discovery discovery;
+    discovery.scannedFiles.emplace(mainFilePath.string(), nullptr);
+    discoverFile(mainFilePath, discovery);
+    if (discovery.threadPool) {
+        discovery.threadPool->wait();
+    }
+    return std::move(discovery.scannedFiles);
+}
+
+void Preprocessor::discoverFile(const std::filesystem::path& filePath, Discovery& discovery) {
+    auto scannedFile = std::make_unique<ScannedFile>(scanFile(filePath));
+
+    // every file is read only once, by the one who finds it first
+    std::vector<std::filesystem::path> newFiles;
+    {
+        std::lock_guard<std::mutex> lock(discovery.mutex);
+        for (const auto& include : scannedFile->includes) {
+            if (include.error.empty() && include.includePath.extension() == ".lorem" 
+                && discovery.scannedFiles.emplace(include.includePath.string(), nullptr).second) {
+                newFiles.push_back(include.includePath);
+            }
+        }
+        discovery.scannedFiles[filePath.string()] = std::move(scannedFile);
+
+        // NOTE: nothing is waiting for I/O, when there is a single include, so it's read without a thread pool
+        if (newFiles.size() > 1 && !discovery.threadPool) {
+            discovery.threadPool.emplace(llvm::hardware_concurrency(s_readThreads));
+        }
+    }
+
+    // siblings are read on thread pool, last one on this thread
+    for (size_t i = 0; i + 1 < newFiles.size(); i++) {
+        discovery.threadPool->async([newFile = newFiles[i], &discovery]() {
+            discoverFile(newFile, discovery);
+        });
+    }
+    if (!newFiles.empty()) {
+        discoverFile(newFiles.back(), discovery);
+    }
+}
+
+ScannedFile Preprocessor::scanFile(const std::filesystem::path& filePath) {
+    ScannedFile scannedFile;
+    scannedFile.buffer = readFile(filePath);
+    if (!scannedFile.buffer) {
+        return scannedFile;
+    }
+
+    llvm::StringRef content = scannedFile.buffer->getBuffer();
+    const std::u8string_view sourceCode = std::u8string_view(reinterpret_cast<const char8_t*>(content.data()), content.size());
+    auto charAt = [&sourceCode](size_t index) {
+        return index < sourceCode.length() ? sourceCode[index] : u8'\0';
+    };
+    const std::string fileNameStr = filePath.filename().string();
+    const std::u8string fileName = std::u8string(fileNameStr.begin(), fileNameStr.end());
 
-    std::unique_ptr<LoremSourceFile> currentFile = std::make_unique<LoremSourceFile>();
-    currentFile->filePath = filePath; 
-    currentFile->sourceCode = readFileToU8String(filePath);
-    
-    std::u8string& sourceCode = currentFile->sourceCode;
     static const std::u8string_view INCLUDE_STR = u8"apere";
     size_t includePos = 0;
-    while ((includePos = sourceCode.find(INCLUDE_STR, includePos)) != std::u8string::npos) {
+    while ((includePos = sourceCode.find(INCLUDE_STR, includePos)) != std::u8string_view::npos) {
         // This checks if the line with 'apere' has only whitespace before it
         {
-            int indexBack = includePos - 1;
-            bool onlyApereInLine = true;
-            while (sourceCode[indexBack] != u8'\n' && indexBack > 0) {
-                if (sourceCode[indexBack] != u8' ' && sourceCode[indexBack] != u8'\t') {
-                    onlyApereInLine = false;
-                    break;
-                }
-                indexBack--;
-            }
+            size_t lineStart = includePos == 0 ? 0 : sourceCode.find_last_of(u8'\n', includePos - 1) + 1; // npos + 1 is 0
+            bool onlyApereInLine = sourceCode.substr(lineStart, includePos - lineStart).find_first_not_of(u8" \t") == std::u8string_view::npos;
             if (!onlyApereInLine) {
-                std::string fileNameStr = filePath.filename().string();
-                ErrorHandler::logError(u8"apere must be the only thing in the line! Error happened in file: " + std::u8string(fileNameStr.begin(), fileNameStr.end()) + u8"!");
+                scannedFile.includes.push_back({includePos, includePos, {}, u8"apere must be the only thing in the line! Error happened in file: " + fileName + u8"!"});
                 includePos = sourceCode.find(INCLUDE_STR, includePos + INCLUDE_STR.length());
                 continue;
             }
@@ -75,59 +166,85 @@ std::unique_ptr<LoremSourceFile> Preprocessor::createFileTree(std::filesystem::p
         size_t index = includePos + INCLUDE_STR.length();
 
         // Skip whitespace after 'apere'
-        while (sourceCode[index] == u8' ' || sourceCode[index] == u8'\t')
+        while (charAt(index) == u8' ' || charAt(index) == u8'\t')
             index++;
         
         // Read the file name from " until the next "
         std::string includeFileName = "";
         {
-            if (sourceCode[index] != '"') {
-                std::string fileNameStr = filePath.filename().string();
-                ErrorHandler::logError(u8"apere must be followed by \"fileName\"! Error happened in file: " + std::u8string(fileNameStr.begin(), fileNameStr.end()) + u8"!");
+            if (charAt(index) != '"') {
+                scannedFile.includes.push_back({includePos, includePos, {}, u8"apere must be followed by \"fileName\"! Error happened in file: " + fileName + u8"!"});
                 includePos = sourceCode.find(INCLUDE_STR, index);
                 continue;
             }
     
             index++; // eat "
     
-            while (sourceCode[index] != '"' && index < sourceCode.length() && sourceCode[index] != '\n') {
+            while (charAt(index) != '"' && index < sourceCode.length() && charAt(index) != '\n') {
                 includeFileName += sourceCode[index];
                 index++;
             }
     
-            if (sourceCode[index] != '"') {
-                std::string fileNameStr = filePath.filename().string();
-                ErrorHandler::logError(u8"apere must be followed by \"fileName\"! Error happened in file: " + std::u8string(fileNameStr.begin(), fileNameStr.end()) + u8"!");
+            if (charAt(index) != '"') {
+                scannedFile.includes.push_back({includePos, includePos, {}, u8"apere must be followed by \"fileName\"! Error happened in file: " + fileName + u8"!"});
                 includePos = sourceCode.find(INCLUDE_STR, index);
                 continue;
             }
             index++; // eat "
-
-            // while(sourceCode[index] == u8' ' || sourceCode[index] == u8'\t')
-            //     index++; // eat whitespace after "fileName"
-            // if (sourceCode[index] == '\r')
-            //     index++; // eat \r
-            // if (sourceCode[index] == '\n')
-            //     index++; // eat \n
         }
-        
-        sourceCode.erase(includePos, index - includePos); // remove apere "fileName", but not the \n
-        index = includePos; // set index to the start of the line
 
         std::filesystem::path includePath = std::filesystem::path(filePath.parent_path()) / std::filesystem::path(includeFileName);
         includePath = std::filesystem::weakly_canonical(includePath); // Get the absolute path
+        scannedFile.includes.push_back({includePos, index, std::move(includePath), {}});
+        includePos = sourceCode.find(INCLUDE_STR, index);
+    }
+    return scannedFile;
+}
+
+std::unique_ptr<LoremSourceFile> Preprocessor::createFileTree(const std::filesystem::path& filePath, const ScannedFileMap& scannedFiles, std::unordered_set<std::string>& includingFiles) {
+    llvm::TimeTraceScope scope("Load file", [&]() { return filePath.string(); });
+    includingFiles.insert(filePath.string());
+    m_includedFiles.emplace_back(filePath);
+    m_includedFileSet.insert(filePath.string());
+
+    auto scanned = scannedFiles.find(filePath.string());
+    assert(scanned != scannedFiles.end() && scanned->second && "every included file is discovered");
+    const ScannedFile& scannedFile = *scanned->second;
+
+    std::unique_ptr<LoremSourceFile> currentFile = std::make_unique<LoremSourceFile>();
+    currentFile->filePath = filePath; 
+    currentFile->buffer = scannedFile.buffer;
+    if (!currentFile->buffer) {
+        std::string pathStr = filePath.string();
+        ErrorHandler::logError(u8"File " + std::u8string(pathStr.begin(), pathStr.end()) + u8" isn't found");
+    } else {
+        llvm::StringRef content = currentFile->buffer->getBuffer();
+        currentFile->sourceCode = std::u8string_view(reinterpret_cast<const char8_t*>(content.data()), content.size());
+    }
+    
+    // NOTE: directives aren't erased from mapped file, they are recorded as skipped ranges instead
+    const std::u8string_view sourceCode = currentFile->sourceCode;
+    size_t linesUntil = 0; // lines are counted from here on
+    size_t lineCount = 0;
+    for (const IncludeDirective& include : scannedFile.includes) {
+        if (!include.error.empty()) {
+            ErrorHandler::logError(include.error);
+            continue;
+        }
+        currentFile->skippedRanges.emplace_back(include.begin, include.end); // skip apere "fileName", but not the \n
+
+        const std::filesystem::path& includePath = include.includePath;
         
         // Check if there is a circle in inclusion
-        if (std::find(includingStack.begin(), includingStack.end(), includePath) != includingStack.end()) {
+        const std::string includePathStr = includePath.string();
+        if (includingFiles.contains(includePathStr)) {
             std::string fileNameStr = filePath.filename().string();
             ErrorHandler::logError(u8"Detected circle in inclusion for file: " + std::u8string(fileNameStr.begin(), fileNameStr.end()) +  u8"!");
-            includePos = sourceCode.find(INCLUDE_STR, index);
             continue;
         }
 
         // Check if the file is already included
-        if (std::find(m_includedFiles.begin(), m_includedFiles.end(), includePath) != m_includedFiles.end()) {
-            includePos = sourceCode.find(INCLUDE_STR, index);
+        if (m_includedFileSet.contains(includePathStr)) {
             continue;
         }
 
@@ -136,88 +253,121 @@ std::unique_ptr<LoremSourceFile> Preprocessor::createFileTree(std::filesystem::p
         if (extension == ".a" || extension == ".so" || extension == ".dll" || extension == ".o") {
             m_linkLibraries.push_back(includePath);
             m_includedFiles.push_back(includePath);
+            m_includedFileSet.insert(includePathStr);
         }
         // It's a file, process it recursively
         else if (extension == ".lorem") {
-            auto includeFile = createFileTree(includePath, includingStack);
-            int line = countLines(sourceCode, index);
-            currentFile->includedLorem.emplace_back(line, std::move(includeFile));
+            if (m_usePrecompiledModules && includePrecompiledModule(includePath, scannedFiles)) {
+                continue;
+            }
+            auto includeFile = createFileTree(includePath, scannedFiles, includingFiles);
+            lineCount += countLines(sourceCode, linesUntil, include.begin);
+            linesUntil = include.begin;
+            currentFile->includedLorem.emplace_back(lineCount, std::move(includeFile));
         }
         else {
             std::string filePathStr = includePath.string();
             ErrorHandler::logError(u8"Unknown file type " + std::u8string(filePathStr.begin(), filePathStr.end()) + u8"!");
         }
-
-        includePos = sourceCode.find(INCLUDE_STR, index);
     }
 
-    if (includingStack.back() != filePath) {
-        std::string fileNameStr = filePath.filename().string();
-        ErrorHandler::logError(u8"Detected circle in inclusion for file: " + std::u8string(fileNameStr.begin(), fileNameStr.end()) +  u8"!");
-    }
-    includingStack.pop_back();
+    includingFiles.erase(filePath.string());
     return currentFile;
 }
 
 
-std::vector<SourceLine> Preprocessor::mergeFiles(const LoremSourceFile* file) {
-    assert(file);
-    std::vector<SourceLine> lines;
-
-    const std::u8string& code = file->sourceCode;
-    size_t lineStart = 0;
-    for (size_t i = 0; i < code.length(); i++) {
-        if (code[i] == u8'\n') {
-            lines.emplace_back(
-                std::u8string(code.begin() + lineStart, code.begin() + i + 1), // Include the last character if it's not a newline
-                lines.size(), 
-                file->filePath
-            );
-            lineStart = i + 1; // Move to the next line
-        }
-    }
-    // last line (if it doesn't end with a newline)
-    lines.emplace_back(
-        std::u8string(code.begin() + lineStart, code.begin() + code.length()),
-        lines.size(), 
-        file->filePath
-    );
-    if(lines.back().line.back() != u8'\n') {
-        lines.back().line += u8'\n'; // Add a newline at the end of the last line if it doesn't exist
+bool Preprocessor::includePrecompiledModule(const std::filesystem::path& filePath, const ScannedFileMap& scannedFiles) {
+    std::unique_ptr<PrecompiledModule> module = PrecompiledModule::load(PrecompiledModule::getModulePath(filePath));
+    if (!module || module->getSourceFiles().front().first != filePath) {
+        return false;
     }
-    
-    size_t offset = 0;
-    for (const auto& includedFile : file->includedLorem) {
-        size_t line = includedFile.first;
-        const auto& file = includedFile.second;
 
-        // Recursively merge the source code of the included file
-        auto fileLines = mergeFiles(file.get());
-        lines.insert(lines.begin() + line + offset, fileLines.begin(), fileLines.end());
-        offset += fileLines.size(); // Adjust the offset for the next included file
+    // NOTE: Module is used only if none of it's files is included already, otherwise their code would be there twice
+    for (const auto& [sourceFilePath, hash] : module->getSourceFiles()) {
+        const std::string pathStr = sourceFilePath.string();
+        if (m_includedFileSet.contains(pathStr)) {
+            return false;
+        }
+        // Files of module were read while includes were discovered
+        auto scanned = scannedFiles.find(pathStr);
+        std::shared_ptr<const llvm::MemoryBuffer> buffer = scanned != scannedFiles.end() && scanned->second ? scanned->second->buffer : readFile(sourceFilePath);
+        if (!buffer || PrecompiledModule::hashSourceFile(buffer->getBuffer()) != hash) {
+            return false;
+        }
     }
 
-    return lines;
+    for (const auto& [sourceFilePath, hash] : module->getSourceFiles()) {
+        m_includedFiles.push_back(sourceFilePath);
+        m_includedFileSet.insert(sourceFilePath.string());
+    }
+    for (const auto& library : module->getLinkLibraries()) {
+        if (m_includedFileSet.insert(library.string()).second) {
+            m_linkLibraries.push_back(library);
+            m_includedFiles.push_back(library);
+        }
+    }
+    m_includedFiles.push_back(module->getFilePath());
+    m_includedFileSet.insert(module->getFilePath().string());
+    m_precompiledModules.push_back(std::move(module));
+    return true;
 }
 
-std::u8string Preprocessor::readFileToU8String(std::filesystem::path& filePath) {
-    std::ifstream file = std::ifstream(filePath, std::ios::binary);  // Open file in binary mode
-    if (!file) {
-        std::string pathStr = filePath.string();
-        ErrorHandler::logError(u8"File " + std::u8string(pathStr.begin(), pathStr.end()) + u8" isn't found");
-        return u8"";
+std::vector<const LoremSourceFile*> Preprocessor::getModuleUnits() const {
+    std::vector<const LoremSourceFile*> units;
+    collectModuleUnits(m_rootFile.get(), units);
+    return units;
+}
+
+void Preprocessor::collectModuleUnits(const LoremSourceFile* file, std::vector<const LoremSourceFile*>& outUnits) {
+    for (const auto& includedFile : file->includedLorem) {
+        collectModuleUnits(includedFile.second.get(), outUnits);
     }
+    outUnits.push_back(file);
+}
 
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    return std::u8string(content.begin(), content.end());  // Convert to u8string
+void Preprocessor::mergeFiles(const LoremSourceFile* file, bool withIncludedFiles, SourceManager& outSources) {
+    assert(file);
+    FileId fileId = outSources.addFile(file->filePath, file->sourceCode);
+
+    // lines of file up to apere of included file, then included file
+    size_t line = 0;
+    if (withIncludedFiles) {
+        for (const auto& includedFile : file->includedLorem) {
+            outSources.appendLines(fileId, line, includedFile.first, file->skippedRanges);
+            mergeFiles(includedFile.second.get(), true, outSources);
+            line = includedFile.first;
+        }
+    }
+    outSources.appendLines(fileId, line, outSources.getLineCount(fileId), file->skippedRanges);
 }
 
-int Preprocessor::countLines(const std::u8string& str, size_t untilPos) {
-    int count = 0;
-    for (size_t i = 0; i < untilPos; i++) {
-        if (str[i] == u8'\n') {
-            count++;
+std::shared_ptr<const llvm::MemoryBuffer> Preprocessor::readFile(const std::filesystem::path& filePath) {
+    std::error_code errorCode;
+    std::filesystem::file_time_type lastWriteTime;
+    if (s_fileCacheEnabled) {
+        lastWriteTime = std::filesystem::last_write_time(filePath, errorCode);
+        std::lock_guard<std::mutex> lock(s_fileCacheMutex);
+        auto cached = s_fileCache.find(filePath.string());
+        if (!errorCode && cached != s_fileCache.end() && cached->second.lastWriteTime == lastWriteTime) {
+            return cached->second.content;
         }
     }
-    return count;
+
+    // NOTE: Cached files outlive the compilation, while the file may be overwritten in place,
+    //       so they are read into memory instead of being mapped (volatile)
+    auto file = llvm::MemoryBuffer::getFile(filePath.string(), false, true, s_fileCacheEnabled);
+    if (!file) {
+        return nullptr;
+    }
+
+    std::shared_ptr<const llvm::MemoryBuffer> content = std::move(file.get());
+    if (s_fileCacheEnabled && !errorCode) {
+        std::lock_guard<std::mutex> lock(s_fileCacheMutex);
+        s_fileCache[filePath.string()] = CachedFile{ lastWriteTime, content };
+    }
+    return content;
+}
+
+size_t Preprocessor::countLines(std::u8string_view str, size_t fromPos, size_t untilPos) {
+    return std::count(str.begin() + fromPos, str.begin() + untilPos, u8'\n');
 }
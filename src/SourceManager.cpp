@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <cstring>
+#include "SourceManager.hpp"
+
+SourceManager::SourceManager()
+    : m_files()
+    , m_chunks()
+    , m_mergedLineCount(0)
+    , m_mergedCode() {}
+
+FileId SourceManager::addFile(const std::filesystem::path& filePath, std::u8string_view sourceCode) {
+    File& file = m_files.emplace_back(File{filePath, sourceCode, {0}});
+
+    // memchr looks at many bytes at a time, lines are found without looking at every byte in a loop
+    const char8_t* begin = sourceCode.data();
+    const char8_t* end = begin + sourceCode.size();
+    for (const char8_t* it = begin; it != end;) {
+        const void* newLine = std::memchr(it, u8'\n', end - it);
+        if (!newLine) {
+            break;
+        }
+        it = static_cast<const char8_t*>(newLine) + 1;
+        file.lineOffsets.push_back(it - begin);
+    }
+    return static_cast<FileId>(m_files.size() - 1);
+}
+
+void SourceManager::appendLines(FileId fileId, size_t firstLine, size_t endLine, const std::vector<std::pair<size_t, size_t>>& skippedRanges) {
+    const File& file = m_files[fileId];
+    assert(firstLine <= endLine && endLine <= file.lineOffsets.size());
+    if (firstLine == endLine) {
+        return;
+    }
+
+    m_chunks.push_back(Chunk{m_mergedLineCount, fileId, firstLine});
+    m_mergedLineCount += endLine - firstLine;
+
+    const bool isLastLine = endLine == file.lineOffsets.size();
+    size_t begin = file.lineOffsets[firstLine];
+    const size_t end = isLastLine ? file.sourceCode.size() : file.lineOffsets[endLine];
+
+    auto skipped = std::lower_bound(skippedRanges.begin(), skippedRanges.end(), std::make_pair(begin, size_t(0)));
+    for (; skipped != skippedRanges.end() && skipped->first < end; skipped++) {
+        m_mergedCode.append(file.sourceCode.substr(begin, skipped->first - begin));
+        begin = skipped->second;
+    }
+    m_mergedCode.append(file.sourceCode.substr(begin, end - begin));
+    if (isLastLine) {
+        m_mergedCode += u8'\n';
+    }
+}
+
+const std::u8string& SourceManager::getMergedCode() const {
+    return m_mergedCode;
+}
+
+size_t SourceManager::getLineCount(FileId file) const {
+    return m_files[file].lineOffsets.size();
+}
+
+const std::filesystem::path& SourceManager::getFilePath(FileId file) const {
+    return m_files[file].filePath;
+}
+
+std::u8string_view SourceManager::getLine(FileId fileId, size_t lineIndex) const {
+    const File& file = m_files[fileId];
+    assert(lineIndex < file.lineOffsets.size());
+    size_t begin = file.lineOffsets[lineIndex];
+    size_t end = lineIndex + 1 < file.lineOffsets.size() ? file.lineOffsets[lineIndex + 1] : file.sourceCode.size();
+    return file.sourceCode.substr(begin, end - begin);
+}
+
+SourceLocation SourceManager::getLocation(size_t mergedLine) const {
+    assert(mergedLine < m_mergedLineCount);
+    // last chunk, which starts at or before mergedLine
+    auto chunk = std::upper_bound(m_chunks.begin(), m_chunks.end(), mergedLine, [](size_t line, const Chunk& chunk) {
+        return line < chunk.mergedLine;
+    }) - 1;
+    return SourceLocation{chunk->file, chunk->firstLine + (mergedLine - chunk->mergedLine)};
+}
@@ -0,0 +1,60 @@
+#include "TokenStream.hpp"
+
+TokenStream::TokenStream(Lexer& lexer, std::ostream& ostr)
+    : m_lexer(&lexer)
+    , m_tokens(nullptr)
+    , m_tokenIndex(0)
+    , m_ostr(ostr)
+    , m_isFinished(false)
+    , m_buffer()
+    , m_head(0)
+    , m_size(0) {
+    #if !defined(NDEBUG)
+    m_ostr << "----------------------- Tokens: ----------------------- " << std::endl << std::endl;
+    #endif
+}
+
+TokenStream::TokenStream(const std::vector<Token>& tokens)
+    : m_lexer(nullptr)
+    , m_tokens(&tokens)
+    , m_tokenIndex(0)
+    , m_ostr(std::cout)
+    , m_isFinished(false)
+    , m_buffer()
+    , m_head(0)
+    , m_size(0) {
+    assert(!tokens.empty() && tokens.back().type == TokenType::EOF_TOKEN);
+}
+
+const Token& TokenStream::peek(size_t offset) {
+    assert(offset < LOOKAHEAD);
+    fill(offset + 1);
+    return m_buffer[(m_head + offset) & (LOOKAHEAD - 1)];
+}
+
+void TokenStream::fillSlow(size_t count) {
+    while (m_size < count) {
+        pull(m_buffer[(m_head + m_size) & (LOOKAHEAD - 1)]);
+        m_size++;
+    }
+}
+
+// NOTE: token is written straight into the buffer slot, returning it by value
+//       and copying it into the slot was a few times slower
+void TokenStream::pull(Token& outToken) {
+    if (m_isFinished) {
+        outToken = {TokenType::EOF_TOKEN, u8""};
+        return;
+    }
+
+    if (m_lexer) {
+        outToken = m_lexer->getNextToken();
+        #if !defined(NDEBUG)
+        Lexer::printToken(m_ostr, outToken);
+        #endif
+    } else {
+        outToken = (*m_tokens)[m_tokenIndex++];
+    }
+
+    m_isFinished = outToken.type == TokenType::EOF_TOKEN;
+}
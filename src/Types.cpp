@@ -7,6 +7,8 @@ llvm::Type* PrimitiveDataType::getLLVMType(llvm::LLVMContext& context) const {
     switch(type) {
         case PrimitiveType::INT:
             return llvm::Type::getInt32Ty(context);
+        case PrimitiveType::LONG:
+            return llvm::Type::getInt64Ty(context);
         case PrimitiveType::BOOL:
             return llvm::Type::getInt1Ty(context);
         case PrimitiveType::CHAR:
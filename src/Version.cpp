@@ -0,0 +1,26 @@
+#include "Version.hpp"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/xxhash.h"
+
+const std::string& getCompilerIdentity() {
+    // NOTE: Version string isn't bumped on every change, hash of the executable changes with every build
+    static const std::string identity = []() {
+        #if defined(__linux__)
+            const std::string executablePath = "/proc/self/exe"; // running binary, even if it was replaced on disk meanwhile
+        #else
+            static int anchor;
+            const std::string executablePath = llvm::sys::fs::getMainExecutable(nullptr, &anchor);
+        #endif
+
+        std::string identity = std::string(LSC_VERSION) + " LLVM " + LLVM_VERSION_STRING;
+        auto executable = llvm::MemoryBuffer::getFile(executablePath, false, false);
+        if (executable) {
+            identity += " " + llvm::utohexstr(llvm::xxh3_64bits(llvm::arrayRefFromStringRef((*executable)->getBuffer())), true);
+        }
+        return identity;
+    }();
+    return identity;
+}
@@ -0,0 +1,50 @@
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "IRGenerator.hpp"
+#include "Assembler.hpp"
+#include "gtest/gtest.h"
+
+// Thin lto bitcode carries summary of every function with it's calls, linker imports functions by it
+TEST(TestAssembler, ThinBitcodeHasSummaryOfCalls) {
+    std::ostringstream oss;
+    std::ostringstream ossDump;
+    ErrorHandler::reset();
+    ErrorHandler::setOutput(&oss);
+    ErrorHandler::setLogOutput(&ossDump);
+
+    const std::u8string sourceCode =
+        u8"numerus duplex = λ(numerus n):\n"
+        u8"    retro n × II\n"
+        u8";\n"
+        u8"numerus x = duplex(XXI)\n";
+    Lexer lexer(sourceCode);
+    TokenStream tokens(lexer, ossDump);
+    Parser parser(tokens, false, ossDump);
+    std::unique_ptr<AST> tree = parser.parse();
+    IRGenerator codeGenerator = IRGenerator("thin", tree);
+    codeGenerator.generateIRCode();
+    ASSERT_FALSE(ErrorHandler::hasError()) << oss.str();
+
+    CodeGenOptions options;
+    options.lto = LTOMode::Thin;
+    Assembler::initializeTargets();
+    Assembler assembler = Assembler(options);
+    std::vector<ObjectBuffer> buffers;
+    ASSERT_TRUE(assembler.compileToObjectBuffers(&buffers, codeGenerator.getModule()));
+    ASSERT_EQ(buffers.size(), 1u);
+
+    auto summaryIndex = getModuleSummaryIndex(MemoryBufferRef(StringRef(buffers[0].data(), buffers[0].size()), "thin"));
+    ASSERT_TRUE(bool(summaryIndex)) << toString(summaryIndex.takeError());
+    size_t callCount = 0;
+    for (const auto& [guid, info] : **summaryIndex) {
+        for (const auto& summary : info.SummaryList) {
+            if (const auto* functionSummary = dyn_cast<FunctionSummary>(summary.get())) {
+                callCount += functionSummary->calls().size();
+            }
+        }
+    }
+    EXPECT_GT(callCount, 0u);
+
+    ErrorHandler::setOutput(&std::cerr);
+    ErrorHandler::setLogOutput(&std::cout);
+}
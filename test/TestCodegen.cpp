@@ -0,0 +1,67 @@
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "IRGenerator.hpp"
+#include "gtest/gtest.h"
+
+static std::string generateIR(const std::u8string& sourceCode) {
+    std::ostringstream oss;
+    std::ostringstream ossDump;
+    ErrorHandler::reset();
+    ErrorHandler::setOutput(&oss);
+    ErrorHandler::setLogOutput(&ossDump);
+
+    Lexer lexer(sourceCode);
+    TokenStream tokens(lexer, ossDump);
+    Parser parser(tokens, false, ossDump);
+    std::unique_ptr<AST> tree = parser.parse();
+    std::string irCode;
+    if (parser.isValid() && tree != nullptr && !ErrorHandler::hasError()) {
+        IRGenerator codeGenerator = IRGenerator("codegen", tree);
+        codeGenerator.generateIRCode();
+        if (!ErrorHandler::hasError()) {
+            llvm::raw_string_ostream irStream(irCode);
+            codeGenerator.getModule()->print(irStream, nullptr);
+        }
+    }
+
+    ErrorHandler::setOutput(&std::cerr);
+    ErrorHandler::setLogOutput(&std::cout);
+    return irCode;
+}
+
+// Returned value and arguments are stored through pointers, so their width has to match the declared type
+TEST(TestCodegen, ReturnConvertsToDeclaredType) {
+    const std::string irCode = generateIR(
+        u8"numerus narrow = λ():\n"
+        u8"    magnus value = XLII_O_VII\n"
+        u8"    retro value\n"
+        u8";\n"
+        u8"magnus wide = λ():\n"
+        u8"    numerus value = XLII\n"
+        u8"    retro value\n"
+        u8";\n"
+        u8"numerus x = narrow()\n"
+        u8"magnus y = wide()\n"
+    );
+    ASSERT_FALSE(irCode.empty());
+    EXPECT_NE(irCode.find("trunc i64"), std::string::npos);
+    EXPECT_NE(irCode.find("sext i32"), std::string::npos);
+}
+
+TEST(TestCodegen, ArgumentConvertsToParameterType) {
+    const std::string irCode = generateIR(
+        u8"numerus narrow = λ(numerus a):\n"
+        u8"    retro a\n"
+        u8";\n"
+        u8"magnus wide = λ(magnus a):\n"
+        u8"    retro a\n"
+        u8";\n"
+        u8"magnus big = XLII_O_VII\n"
+        u8"numerus small = XLII\n"
+        u8"numerus x = narrow(big)\n"
+        u8"magnus y = wide(small)\n"
+    );
+    ASSERT_FALSE(irCode.empty());
+    EXPECT_NE(irCode.find("trunc i64"), std::string::npos);
+    EXPECT_NE(irCode.find("sext i32"), std::string::npos);
+}
@@ -0,0 +1,65 @@
+#include "generator/ProgramGenerator.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "IRGenerator.hpp"
+#include "Preprocessor.hpp"
+#include "gtest/gtest.h"
+
+// Generated programs must be valid at every scale, otherwise benchmarks measure error recovery
+class TestGeneratorValid : public ::testing::TestWithParam<GeneratorOptions> {};
+
+static bool compilesWithoutErrors(const std::u8string& sourceCode) {
+    std::ostringstream oss;
+    std::ostringstream ossDump;
+    ErrorHandler::reset();
+    ErrorHandler::setOutput(&oss);
+
+    Lexer lexer(sourceCode);
+    TokenStream tokens(lexer, ossDump);
+    Parser parser(tokens, false, ossDump);
+    std::unique_ptr<AST> tree = parser.parse();
+    bool isValid = parser.isValid() && tree != nullptr && !ErrorHandler::hasError();
+    if (isValid) {
+        // NOTE: Debug builds print IR to std::cout
+        std::streambuf* coutBuffer = std::cout.rdbuf(ossDump.rdbuf());
+        IRGenerator codeGenerator = IRGenerator("generated", tree);
+        codeGenerator.generateIRCode();
+        std::cout.rdbuf(coutBuffer);
+        isValid = !ErrorHandler::hasError();
+    }
+
+    ErrorHandler::setOutput(&std::cerr);
+    return isValid;
+}
+
+TEST_P(TestGeneratorValid, SingleFile) {
+    ProgramGenerator generator = ProgramGenerator(GetParam());
+    EXPECT_TRUE(compilesWithoutErrors(generator.generate()));
+}
+
+TEST_P(TestGeneratorValid, IncludedFiles) {
+    GeneratorOptions options = GetParam();
+    options.includeFanOut = 4;
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / ("lscTestGenerator-" + std::to_string(options.seed));
+    ProgramGenerator generator = ProgramGenerator(options);
+
+    Preprocessor preprocessor = Preprocessor(generator.writeFiles(directory));
+    EXPECT_TRUE(compilesWithoutErrors(preprocessor.getMergedSourceCode()));
+    std::filesystem::remove_all(directory);
+}
+
+INSTANTIATE_TEST_SUITE_P(TestGenerator, TestGeneratorValid, ::testing::Values(
+    GeneratorOptions{ .functionCount = 1, .nestingDepth = 0, .expressionLength = 1, .includeFanOut = 0, .structCount = 0, .arrayCount = 0, .seed = 1 },
+    GeneratorOptions{ .functionCount = 10, .nestingDepth = 2, .expressionLength = 4, .includeFanOut = 0, .structCount = 1, .arrayCount = 1, .seed = 2 },
+    GeneratorOptions{ .functionCount = 50, .nestingDepth = 6, .expressionLength = 12, .includeFanOut = 0, .structCount = 8, .arrayCount = 3, .seed = 3 },
+    GeneratorOptions{ .functionCount = 500, .nestingDepth = 3, .expressionLength = 6, .includeFanOut = 0, .structCount = 20, .arrayCount = 2, .seed = 4 }
+));
+
+TEST(TestGenerator, SameSeedSameProgram) {
+    GeneratorOptions options;
+    options.seed = 42;
+    EXPECT_EQ(ProgramGenerator(options).generate(), ProgramGenerator(options).generate());
+
+    options.seed = 43;
+    EXPECT_NE(ProgramGenerator(options).generate(), ProgramGenerator(GeneratorOptions{}).generate());
+}
@@ -11,12 +11,141 @@ TEST(BasicTest, TestLexerWithBasicCode) {
         auto expectedToken = EXPECTED_TOKENS[i];
         auto actualToken = token[i];
         EXPECT_EQ(actualToken.type, expectedToken.type);
-        EXPECT_STREQ((const char*)(actualToken.value.c_str()), (const char*)(expectedToken.value.c_str()));
+        EXPECT_EQ(actualToken.value, expectedToken.value);
         
     }
     // for(const auto& actualToken : token) {
-    //     std::cout << "{TokenType::" << TOKEN_TYPE_LABELS[(int)actualToken.type] << ", u8\"" << (const char*)(actualToken.value.c_str()) << "\"}," << std::endl;
+    //     std::cout << "{TokenType::" << TOKEN_TYPE_LABELS[(int)actualToken.type] << ", u8\"" << std::string_view((const char*)actualToken.value.data(), actualToken.value.size()) << "\"}," << std::endl;
     // }
 
     EXPECT_EQ(token.size(), EXPECTED_TOKENS.size());
-}
\ No newline at end of file
+}
+TEST(BasicTest, TestLexerWordsInsideIdentifiers) {
+    const std::u8string sourceCode = u8"sisi nihilum veritas λx ni nisi ¬veri abc≠d numerus[II]";
+    const std::vector<Token> expectedTokens = {
+        {TokenType::IDENTIFIER, u8"sisi"},
+        {TokenType::IDENTIFIER, u8"nihilum"},
+        {TokenType::IDENTIFIER, u8"veritas"},
+        {TokenType::IDENTIFIER, u8"λx"},
+        {TokenType::KEYWORD, u8"ni"},
+        {TokenType::KEYWORD, u8"nisi"},
+        {TokenType::OPERATOR, u8"¬"},
+        {TokenType::BOOL, u8"veri"},
+        {TokenType::IDENTIFIER, u8"abc"},
+        {TokenType::OPERATOR, u8"≠"},
+        {TokenType::IDENTIFIER, u8"d"},
+        {TokenType::TYPE, u8"numerus"},
+        {TokenType::PUNCTUATION, u8"["},
+        {TokenType::NUMBER, u8"II"},
+        {TokenType::PUNCTUATION, u8"]"},
+        {TokenType::EOF_TOKEN, u8""},
+    };
+
+    std::vector<Token> token;
+    std::stringstream oss;
+    Lexer(sourceCode).tokenize(token, oss);
+
+    ASSERT_EQ(token.size(), expectedTokens.size());
+    for (std::vector<Token>::size_type i = 0; i < token.size(); i++) {
+        EXPECT_EQ(token[i].type, expectedTokens[i].type);
+        EXPECT_EQ(token[i].value, expectedTokens[i].value);
+    }
+}
+
+TEST(BasicTest, TestLexerTokenKindsAndIdentifierIds) {
+    const std::u8string sourceCode = u8"numerus abc = abc ≥ d\nsi veri: retro abc;";
+
+    std::vector<Token> token;
+    std::stringstream oss;
+    Lexer(sourceCode).tokenize(token, oss);
+
+    const std::vector<TokenKind> expectedKinds = {
+        TokenKind::INT, TokenKind::NONE, TokenKind::ASSIGN, TokenKind::NONE, TokenKind::GREATER_OR_EQUAL, TokenKind::NONE, TokenKind::NONE,
+        TokenKind::IF, TokenKind::TRUE, TokenKind::BLOCK_OPEN, TokenKind::RETURN, TokenKind::NONE, TokenKind::BLOCK_CLOSE, TokenKind::NONE,
+    };
+    ASSERT_EQ(token.size(), expectedKinds.size());
+    for (std::vector<Token>::size_type i = 0; i < token.size(); i++) {
+        EXPECT_EQ(token[i].kind, expectedKinds[i]);
+        // tokens are views into the source code
+        EXPECT_TRUE(token[i].value.empty() || (token[i].value.data() >= sourceCode.data() && token[i].value.data() < sourceCode.data() + sourceCode.size()));
+    }
+
+    // every occurrence of identifier gets the same id, other tokens get 0
+    EXPECT_NE(token[1].identifierId, 0u);
+    EXPECT_EQ(token[1].identifierId, token[3].identifierId);
+    EXPECT_EQ(token[1].identifierId, token[11].identifierId);
+    EXPECT_NE(token[1].identifierId, token[5].identifierId);
+    EXPECT_EQ(token[0].identifierId, 0u);
+    EXPECT_EQ(token[2].identifierId, 0u);
+}
+
+TEST(BasicTest, TestLexerRomanThousandGroups) {
+    const std::u8string sourceCode = u8"magnus x = XLII_O_VII + X_y";
+
+    std::vector<Token> token;
+    std::stringstream oss;
+    Lexer(sourceCode).tokenize(token, oss);
+
+    // '_' belongs to number only in front of next group
+    const std::vector<std::pair<TokenType, std::u8string_view>> expected = {
+        {TokenType::TYPE, u8"magnus"}, {TokenType::IDENTIFIER, u8"x"}, {TokenType::OPERATOR, u8"="},
+        {TokenType::NUMBER, u8"XLII_O_VII"}, {TokenType::OPERATOR, u8"+"}, {TokenType::NUMBER, u8"X"}, {TokenType::IDENTIFIER, u8"_y"},
+    };
+    ASSERT_GE(token.size(), expected.size());
+    for (std::vector<Token>::size_type i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(token[i].type, expected[i].first);
+        EXPECT_EQ(token[i].value, expected[i].second);
+    }
+    EXPECT_EQ(token[0].kind, TokenKind::LONG);
+}
+
+TEST(BasicTest, TestTokenStreamPullsFromLexer) {
+    const std::u8string sourceCode = u8"numerus a = I + b\nretro a";
+
+    std::vector<Token> expectedTokens;
+    std::stringstream oss;
+    Lexer(sourceCode).tokenize(expectedTokens, oss);
+
+    Lexer lexer(sourceCode);
+    TokenStream tokens(lexer, oss);
+    EXPECT_EQ(tokens.peek(TokenStream::LOOKAHEAD - 1).value, expectedTokens[TokenStream::LOOKAHEAD - 1].value);
+    for (std::vector<Token>::size_type i = 0; i < expectedTokens.size(); i++) {
+        const Token& token = i == 0 ? tokens.current() : tokens.advance();
+        EXPECT_EQ(token.type, expectedTokens[i].type);
+        EXPECT_EQ(token.value, expectedTokens[i].value);
+    }
+
+    // stream stays at the end
+    EXPECT_EQ(tokens.advance().type, TokenType::EOF_TOKEN);
+    EXPECT_EQ(tokens.peek(1).type, TokenType::EOF_TOKEN);
+}
+
+TEST(BasicTest, TestLexerScanKernelsMatchScalar) {
+    const lexer_scan::ByteSet* sets[] = {
+        &lexer_scan::BLANKS, &lexer_scan::LINE_ENDS, &lexer_scan::LITERAL_ENDS, &lexer_scan::STRING_ENDS, &lexer_scan::IDENTIFIER_ENDS,
+    };
+    const std::u8string alphabet = u8"  \t\r\nabcXYZ\"'/()[]:;,=+-%^!λ∑≠⇔≥×÷¬∧∨éä";
+
+    std::mt19937 rng(42);
+    for (int i = 0; i < 2000; i++) {
+        std::u8string text;
+        const size_t length = rng() % 100;
+        for (size_t j = 0; j < length; j++) {
+            text += alphabet[rng() % alphabet.size()];
+        }
+        const char8_t* begin = text.data();
+        const char8_t* end = begin + text.size();
+
+        for (const lexer_scan::ByteSet* set : sets) {
+            const char8_t* expectedOf = lexer_scan::findFirstOf(begin, end, *set, lexer_scan::SimdLevel::SCALAR);
+            const char8_t* expectedNotOf = lexer_scan::findFirstNotOf(begin, end, *set, lexer_scan::SimdLevel::SCALAR);
+            for (auto level : {lexer_scan::SimdLevel::SSSE3, lexer_scan::SimdLevel::AVX2}) {
+                if (level > lexer_scan::getSimdLevel()) {
+                    continue;
+                }
+                EXPECT_EQ(lexer_scan::findFirstOf(begin, end, *set, level), expectedOf);
+                EXPECT_EQ(lexer_scan::findFirstNotOf(begin, end, *set, level), expectedNotOf);
+            }
+        }
+    }
+}
@@ -1,7 +1,9 @@
 #pragma once
+#include <random>
 #include <vector>
 
 #include "Lexer.hpp"
+#include "TokenStream.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
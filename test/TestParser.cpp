@@ -3,12 +3,12 @@
 // --- General section ---
 
 std::string runParser(std::u8string& input) {
-    std::vector<Token> token;
     std::ostringstream oss;
     std::ostringstream oss_dump;
 
-    Lexer(input).tokenize(token, oss_dump);
-    Parser parser(token, true, oss);
+    Lexer lexer(input);
+    TokenStream tokens(lexer, oss_dump);
+    Parser parser(tokens, true, oss);
     auto block = parser.parse();
 
     if (block != nullptr) {
@@ -19,12 +19,12 @@ std::string runParser(std::u8string& input) {
 }
 
 std::string runParserInvalid(std::u8string& input) {
-    std::vector<Token> token;
     std::ostringstream oss;
     std::ostringstream oss_dump;
 
-    Lexer(input).tokenize(token, oss_dump);
-    Parser parser(token, true, oss);
+    Lexer lexer(input);
+    TokenStream tokens(lexer, oss_dump);
+    Parser parser(tokens, true, oss);
     auto block = parser.parse();
 
     if (block != nullptr) {
@@ -217,6 +217,29 @@ INSTANTIATE_TEST_SUITE_P(TestParserExpressionInvalid, TestParserInvalid, ::testi
     u8"var = var--"
 ));
 
+// Tokens are views into source, escapes must not read past end of the token
+TEST(TestParserExpression, TestEmptyCharAndTrailingBackslash) {
+    using namespace std::string_literals;
+    std::u8string emptyChar = u8"var = ''";
+    EXPECT_EQ(runParser(emptyChar),
+        "└── BlockAST\n"
+        "    └── BinaryOperatorAST('=')\n"
+        "        ├── VariableReferenceAST(var)\n"
+        "        └── CharAST('\0')\n"s
+    );
+
+    std::u8string trailingBackslash = u8"var = \"a\\\"";
+    EXPECT_EQ(runParser(trailingBackslash),
+        "└── BlockAST\n"
+        "    └── BinaryOperatorAST('=')\n"
+        "        ├── VariableReferenceAST(var)\n"
+        "        └── ArrayAST[3]\n"
+        "            ├── CharAST('a')\n"
+        "            ├── CharAST('\0')\n"
+        "            └── CharAST('\0')\n"s
+    );
+}
+
 // --- Declaration section ---
 
 INSTANTIATE_TEST_SUITE_P(TestParserDeclarationValid, TestParserValid, ::testing::Values(
@@ -227,6 +250,13 @@ INSTANTIATE_TEST_SUITE_P(TestParserDeclarationValid, TestParserValid, ::testing:
         "        ├── VariableDeclarationAST(numerus var)\n"
         "        └── NumberAST(1)\n"
     ),
+    std::make_pair(
+        u8"magnus var = IX_CCXXIII_CCCLXXII_XXXVI_DCCCLIV_DCCLXXV_DCCCVII",
+        "└── BlockAST\n"
+        "    └── BinaryOperatorAST('=')\n"
+        "        ├── VariableDeclarationAST(magnus var)\n"
+        "        └── NumberAST(9223372036854775807)\n"
+    ),
     std::make_pair(
         u8"numerus id = I + II × (III + IV)",
         "└── BlockAST\n"
@@ -421,6 +451,8 @@ INSTANTIATE_TEST_SUITE_P(TestParserDeclarationValid, TestParserValid, ::testing:
 
 INSTANTIATE_TEST_SUITE_P(TestParserDeclarationInvalid, TestParserInvalid, ::testing::Values(
     u8"numerus X = I",
+    u8"magnus var = IX_CCXXIII_CCCLXXII_XXXVI_DCCCLIV_DCCLXXV_DCCCVIII",
+    u8"magnus var = III_O",
     u8"numerus numerus = I",
     u8"numerus si = I",
     u8"numerus nisi = I",
@@ -0,0 +1,91 @@
+#include "PrecompiledModule.hpp"
+#include "ModuleCompiler.hpp"
+#include "Preprocessor.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "IRGenerator.hpp"
+#include "gtest/gtest.h"
+#include <fstream>
+
+static void writeFile(const std::filesystem::path& filePath, std::string_view content) {
+    std::ofstream file = std::ofstream(filePath, std::ios::binary);
+    file << content;
+}
+
+// lsc --emit-module, debug dumps are kept out of test output
+static bool emitModule(const std::filesystem::path& filePath) {
+    Preprocessor preprocessor = Preprocessor(filePath, false, false);
+    std::ostringstream ossDump;
+    ErrorHandler::setLogOutput(&ossDump);
+    const bool isEmitted = ModuleCompiler::emitPrecompiledModule(preprocessor, filePath);
+    ErrorHandler::setLogOutput(&std::cout);
+    return isEmitted;
+}
+
+TEST(BasicTest, TestPrecompiledModuleReplacesInclude){
+    const std::filesystem::path directory = std::filesystem::weakly_canonical(std::filesystem::temp_directory_path() / "lscTestPrecompiledModule");
+    std::filesystem::create_directories(directory);
+    writeFile(directory / "lib.lorem",
+        "apere \"util.lorem\"\n"
+        "rerum punctum = (numerus x, numerus y)\n"
+        "numerus counter = VII\n"
+        "numerus duplex = λ(numerus n):\n"
+        "    retro n × II\n"
+        ";\n"
+        "counter += I\n");
+    writeFile(directory / "util.lorem", "numerus printf = λ(litera str)\n");
+    writeFile(directory / "main.lorem", "apere \"lib.lorem\"\napere \"util.lorem\"\npunctum p\np[x] = duplex(counter)\n");
+
+    std::ostringstream oss;
+    ErrorHandler::reset();
+    ErrorHandler::setOutput(&oss);
+    ASSERT_TRUE(emitModule(directory / "lib.lorem"));
+
+    std::unique_ptr<PrecompiledModule> module = PrecompiledModule::load(directory / "lib.lmod");
+    ASSERT_NE(module, nullptr);
+    ASSERT_EQ(module->getSourceFiles().size(), 2u);
+    EXPECT_EQ(module->getSourceFiles()[0].first, directory / "lib.lorem");
+    EXPECT_EQ(module->getStructNames(), std::vector<std::u8string>{u8"punctum"});
+    EXPECT_EQ(module->getInterface()->getInstructions().size(), 4u); // printf, punctum, counter, duplex
+    EXPECT_FALSE(module->getBitcode().getBuffer().empty());
+
+    // lib.lorem and util.lorem aren't part of merged source anymore
+    {
+        Preprocessor preprocessor = Preprocessor(directory / "main.lorem");
+        ASSERT_EQ(preprocessor.getPrecompiledModules().size(), 1u);
+        EXPECT_EQ(preprocessor.getMergedSourceCode().find(u8"λ"), std::u8string::npos);
+        EXPECT_EQ(preprocessor.getIncludedFiles().back(), directory / "lib.lmod");
+
+        std::ostringstream ossDump;
+        Lexer lexer(preprocessor.getMergedSourceCode());
+        TokenStream tokens(lexer, ossDump);
+        Parser parser(tokens, false, ossDump);
+        for (const auto& structName : preprocessor.getPrecompiledModules()[0]->getStructNames()) {
+            parser.addStructName(structName);
+        }
+        std::unique_ptr<AST> tree = parser.parse();
+
+        std::streambuf* coutBuffer = std::cout.rdbuf(ossDump.rdbuf());
+        IRGenerator codeGenerator = IRGenerator("main", tree);
+        codeGenerator.generateInterface(preprocessor.getPrecompiledModules()[0]->getInterface());
+        codeGenerator.generateIRCode();
+        codeGenerator.linkModule(preprocessor.getPrecompiledModules()[0]->getBitcode());
+        std::cout.rdbuf(coutBuffer);
+        EXPECT_FALSE(ErrorHandler::hasError()) << oss.str();
+        EXPECT_FALSE(codeGenerator.getModule()->getFunction("duplex")->isDeclaration());
+    }
+
+    // Changed file makes module stale, source is included again
+    writeFile(directory / "util.lorem", "numerus printf = λ(litera str)\nnumerus puts = λ(litera str)\n");
+    {
+        Preprocessor preprocessor = Preprocessor(directory / "main.lorem");
+        EXPECT_TRUE(preprocessor.getPrecompiledModules().empty());
+    }
+
+    // Damaged module isn't loaded
+    std::filesystem::resize_file(directory / "lib.lmod", std::filesystem::file_size(directory / "lib.lmod") - 1);
+    EXPECT_EQ(PrecompiledModule::load(directory / "lib.lmod"), nullptr);
+
+    ErrorHandler::setOutput(&std::cerr);
+    std::filesystem::remove_all(directory);
+}
@@ -1,28 +1,70 @@
 #include "RomanNumber.hpp"
 #include "gtest/gtest.h"
-#include <stdexcept>
+#include <limits>
 
-TEST(BasicTest, MethodVsMethod){
-    int autoArabic = 0;
+TEST(BasicTest, RoundTrip){
     int arabic = 0;
     for (int i = -3999; i < 4000; i++){
         EXPECT_TRUE(toArabicConverter(toRomanConverter(i), &arabic));
         EXPECT_EQ(arabic, i);
-        
-        EXPECT_TRUE(toArabicConverterAuto(toRomanConverter(i), &autoArabic));
-        EXPECT_EQ(autoArabic, i);
+
+        RomanBuffer buffer;
+        EXPECT_EQ(toRomanConverter(i, buffer), toRomanConverter(i));
     }
 }
 
 
+TEST(BasicTest, thousandGroups){
+    EXPECT_EQ(toRomanConverter(4000), u8"IV_O");
+    EXPECT_EQ(toRomanConverter(-4000), u8"-IV_O");
+    EXPECT_EQ(toRomanConverter(42000007), u8"XLII_O_VII");
+    EXPECT_EQ(toRomanConverter(std::numeric_limits<int>::min()), u8"-II_CXLVII_CDLXXXIII_DCXLVIII");
+    EXPECT_EQ(toRomanConverter(std::numeric_limits<int64_t>::max()), u8"IX_CCXXIII_CCCLXXII_XXXVI_DCCCLIV_DCCLXXV_DCCCVII");
+
+    int64_t arabic = 0;
+    for (int64_t number : {int64_t(4000), int64_t(1) << 32, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()}) {
+        EXPECT_TRUE(toArabicConverter(toRomanConverter(number), &arabic));
+        EXPECT_EQ(arabic, number);
+    }
+    for (int64_t number = 4000; number < 100000000; number = number * 3 + 1) {
+        EXPECT_TRUE(toArabicConverter(toRomanConverter(number), &arabic));
+        EXPECT_EQ(arabic, number);
+        EXPECT_TRUE(toArabicConverter(toRomanConverter(-number), &arabic));
+        EXPECT_EQ(arabic, -number);
+    }
+}
+
 TEST(BasicTest, outOfBounds){
-    EXPECT_EQ(toRomanConverter(4000), u8"∞");
-    EXPECT_EQ(toRomanConverter(-4000), u8"-∞");
+    int64_t arabic = 0;
+    EXPECT_EQ(parseRomanNumber(u8"IX_CCXXIII_CCCLXXII_XXXVI_DCCCLIV_DCCLXXV_DCCCVIII", &arabic), RomanNumberError::OUT_OF_RANGE);
+    EXPECT_EQ(parseRomanNumber(u8"I_O_O_O_O_O_O_O", &arabic), RomanNumberError::OUT_OF_RANGE);
+    EXPECT_EQ(parseRomanNumber(u8"-IX_CCXXIII_CCCLXXII_XXXVI_DCCCLIV_DCCLXXV_DCCCVIII", &arabic), RomanNumberError::NONE);
+    EXPECT_EQ(arabic, std::numeric_limits<int64_t>::min());
+
+    int intArabic = 0;
+    EXPECT_EQ(parseRomanNumber(u8"II_CXLVII_CDLXXXIII_DCXLVIII", &intArabic), RomanNumberError::OUT_OF_RANGE);
+    EXPECT_EQ(intArabic, 0);
+    EXPECT_EQ(parseRomanNumber(u8"-II_CXLVII_CDLXXXIII_DCXLVIII", &intArabic), RomanNumberError::NONE);
+    EXPECT_EQ(intArabic, std::numeric_limits<int>::min());
 }
 
 TEST(BasicTest, failure){
     int arabic = 0;
     EXPECT_FALSE(toArabicConverter(u8"CMCM", &arabic));
-    EXPECT_FALSE(toArabicConverterAuto(u8"CMCM", &arabic));
+    EXPECT_FALSE(toArabicConverter(u8"∞", &arabic));
 }
 
+TEST(BasicTest, notCanonical){
+    int arabic = 0;
+    for (std::u8string_view romanNumber : {u8"IIII", u8"VV", u8"IC", u8"XM", u8"MMMM", u8"IIV", u8"VX", u8"IXI", u8"DCCCC", u8"-XXXXX",
+                                        u8"III_O", u8"MMM_O", u8"X__V", u8"X_", u8"X_OI"}) {
+        EXPECT_EQ(parseRomanNumber(romanNumber, &arabic), RomanNumberError::NOT_CANONICAL) << (const char*)romanNumber.data();
+        EXPECT_EQ(arabic, 0);
+    }
+    EXPECT_EQ(parseRomanNumber(u8"", &arabic), RomanNumberError::EMPTY);
+    EXPECT_EQ(parseRomanNumber(u8"-", &arabic), RomanNumberError::EMPTY);
+    EXPECT_EQ(parseRomanNumber(u8"XIA", &arabic), RomanNumberError::INVALID_SYMBOL);
+    EXPECT_EQ(parseRomanNumber(u8"-O", &arabic), RomanNumberError::INVALID_SYMBOL);
+    EXPECT_EQ(parseRomanNumber(u8"_X", &arabic), RomanNumberError::INVALID_SYMBOL);
+    EXPECT_EQ(parseRomanNumber(u8"O_V", &arabic), RomanNumberError::INVALID_SYMBOL);
+}
@@ -0,0 +1,32 @@
+#include "SourceManager.hpp"
+#include "gtest/gtest.h"
+
+TEST(BasicTest, TestSourceManagerMapsMergedLines){
+    const std::u8string mainCode = u8"numerus a = I\napere \"lib.lorem\"\nretro a";
+    const std::u8string libCode = u8"numerus b = II\n";
+    const size_t apereBegin = mainCode.find(u8"apere");
+    const size_t apereEnd = mainCode.find(u8'\n', apereBegin);
+
+    SourceManager sources;
+    FileId mainFile = sources.addFile("main.lorem", mainCode);
+    FileId libFile = sources.addFile("lib.lorem", libCode);
+    EXPECT_EQ(sources.getLineCount(mainFile), 3u);
+    EXPECT_EQ(sources.getLineCount(libFile), 2u); // empty line after last \n
+
+    // included file takes place of line with apere, which is left empty
+    sources.appendLines(mainFile, 0, 1);
+    sources.appendLines(libFile, 0, sources.getLineCount(libFile));
+    sources.appendLines(mainFile, 1, sources.getLineCount(mainFile), {{apereBegin, apereEnd}});
+    EXPECT_EQ(sources.getMergedCode(), u8"numerus a = I\nnumerus b = II\n\n\nretro a\n");
+
+    const std::vector<std::pair<FileId, size_t>> expected = {{mainFile, 0}, {libFile, 0}, {libFile, 1}, {mainFile, 1}, {mainFile, 2}};
+    for (size_t line = 0; line < expected.size(); line++) {
+        SourceLocation location = sources.getLocation(line);
+        EXPECT_EQ(location.file, expected[line].first);
+        EXPECT_EQ(location.lineIndexInFile, expected[line].second);
+    }
+
+    EXPECT_EQ(sources.getFilePath(libFile), "lib.lorem");
+    EXPECT_EQ(sources.getLine(mainFile, 1), u8"apere \"lib.lorem\"\n");
+    EXPECT_EQ(sources.getLine(mainFile, 2), u8"retro a");
+}
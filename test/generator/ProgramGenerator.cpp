@@ -0,0 +1,160 @@
+#include "ProgramGenerator.hpp"
+#include "RomanNumber.hpp"
+
+#include <fstream>
+
+static std::u8string toU8(const std::string& str) {
+    return std::u8string(str.begin(), str.end());
+}
+
+static std::u8string functionName(size_t index) {
+    return u8"func" + toU8(std::to_string(index));
+}
+
+ProgramGenerator::ProgramGenerator(const GeneratorOptions& options)
+    : m_options(options)
+    , m_random(options.seed)
+    , m_variableCounter(0) {}
+
+std::u8string ProgramGenerator::generate() {
+    m_random.seed(m_options.seed);
+    return generateUnit(0, 1) + generateCalls();
+}
+
+std::filesystem::path ProgramGenerator::writeFiles(const std::filesystem::path& directory) {
+    m_random.seed(m_options.seed);
+    std::filesystem::create_directories(directory);
+
+    const size_t unitCount = std::max<size_t>(m_options.includeFanOut, 1);
+    std::u8string mainCode;
+    for (size_t unit = 0; unit < unitCount; unit++) {
+        const std::string unitName = "unit" + std::to_string(unit) + ".lorem";
+        std::u8string unitCode = generateUnit(unit, unitCount);
+
+        std::ofstream unitFile(directory / unitName, std::ios::binary);
+        unitFile.write(reinterpret_cast<const char*>(unitCode.data()), unitCode.size());
+        mainCode += u8"apere \"./" + toU8(unitName) + u8"\"\n";
+    }
+    mainCode += u8"\n" + generateCalls();
+
+    const std::filesystem::path mainFilePath = directory / "main.lorem";
+    std::ofstream mainFile(mainFilePath, std::ios::binary);
+    mainFile.write(reinterpret_cast<const char*>(mainCode.data()), mainCode.size());
+    return mainFilePath;
+}
+
+std::u8string ProgramGenerator::generateUnit(size_t unit, size_t unitCount) {
+    std::u8string code;
+
+    // Structs and functions are split into contiguous ranges, functions call only functions of own unit
+    const size_t firstStruct = m_options.structCount * unit / unitCount;
+    const size_t lastStruct = m_options.structCount * (unit + 1) / unitCount;
+    std::vector<std::u8string> structNames;
+    for (size_t i = firstStruct; i < lastStruct; i++) {
+        structNames.push_back(u8"record" + toU8(std::to_string(i)));
+        code += u8"rerum " + structNames.back() + u8" = (numerus x, numerus y, asertio flag)\n";
+    }
+    code += u8"\n";
+
+    const size_t firstFunction = m_options.functionCount * unit / unitCount;
+    const size_t lastFunction = m_options.functionCount * (unit + 1) / unitCount;
+    for (size_t i = firstFunction; i < lastFunction; i++) {
+        code += generateFunction(i, firstFunction, structNames);
+    }
+    return code;
+}
+
+std::u8string ProgramGenerator::generateCalls() {
+    std::u8string code;
+    for (size_t i = 0; i < m_options.functionCount; i++) {
+        code += u8"numerus result" + toU8(std::to_string(i)) + u8" = " + functionName(i) + u8"(" + generateNumber(100) + u8", " + generateNumber(100) + u8")\n";
+    }
+    return code;
+}
+
+std::u8string ProgramGenerator::generateFunction(size_t index, size_t firstFunctionOfUnit, const std::vector<std::u8string>& structNames) {
+    m_variableCounter = 0;
+    const std::u8string indent = u8"    ";
+    std::vector<std::u8string> operands = { u8"a", u8"b" };
+    std::u8string code = u8"numerus " + functionName(index) + u8" = λ(numerus a, numerus b):\n";
+
+    // Previous function is known only in the same unit
+    if (index > firstFunctionOfUnit) {
+        std::u8string name = newVariableName("call");
+        code += indent + u8"numerus " + name + u8" = " + functionName(index - 1) + u8"(a, " + generateNumber(10) + u8")\n";
+        operands.push_back(name);
+    }
+
+    for (size_t i = 0; i < m_options.arrayCount; i++) {
+        std::u8string name = newVariableName("array");
+        code += indent + u8"numerus[IV] " + name + u8" = [";
+        for (size_t element = 0; element < 4; element++) {
+            code += (element == 0 ? u8"" : u8", ") + generateExpression(operands);
+        }
+        code += u8"]\n";
+        operands.push_back(name + u8"[" + toRomanConverter(random(4)) + u8"]");
+    }
+
+    if (!structNames.empty()) {
+        std::u8string name = newVariableName("point");
+        code += indent + structNames[random(structNames.size())] + u8" " + name + u8"\n";
+        code += indent + name + u8"[x] = " + generateExpression(operands) + u8"\n";
+        code += indent + name + u8"[y] = " + generateExpression(operands) + u8"\n";
+        code += indent + name + u8"[flag] = veri\n";
+        operands.push_back(name + u8"[x]");
+        operands.push_back(name + u8"[y]");
+    }
+
+    generateBlock(code, m_options.nestingDepth, indent, operands);
+    code += indent + u8"retro " + generateExpression(operands) + u8"\n";
+    code += u8";\n\n";
+    return code;
+}
+
+void ProgramGenerator::generateBlock(std::u8string& outCode, size_t depth, const std::u8string& indent, std::vector<std::u8string> operands) {
+    std::u8string name = newVariableName("value");
+    outCode += indent + u8"numerus " + name + u8" = " + generateExpression(operands) + u8"\n";
+    operands.push_back(name);
+
+    if (depth > 0) {
+        const std::u8string innerIndent = indent + u8"    ";
+        std::vector<std::u8string> innerOperands = operands; // loop counter is visible only inside
+        if (depth % 2 == 0) {
+            std::u8string counter = newVariableName("i");
+            outCode += indent + u8"∑(numerus " + counter + u8" = O, " + counter + u8" < " + generateNumber(5) + u8", " + counter + u8"++):\n";
+            innerOperands.push_back(counter);
+        } else {
+            outCode += indent + u8"si " + generateExpression(operands) + u8" > " + generateNumber(100) + u8":\n";
+        }
+        generateBlock(outCode, depth - 1, innerIndent, innerOperands);
+        outCode += indent + u8";\n";
+    }
+
+    outCode += indent + u8"a = " + generateExpression(operands) + u8"\n";
+}
+
+std::u8string ProgramGenerator::generateExpression(const std::vector<std::u8string>& operands) {
+    static const std::u8string OPERATORS[] = { u8" + ", u8" - ", u8" × " };
+
+    std::u8string expression;
+    for (size_t i = 0; i < std::max<size_t>(m_options.expressionLength, 1); i++) {
+        if (i > 0) {
+            expression += OPERATORS[random(3)];
+        }
+        // Every third operand is a constant, so expressions don't consist of variables only
+        expression += random(3) == 0 ? generateNumber(20) : operands[random(operands.size())];
+    }
+    return m_options.expressionLength > 2 ? u8"(" + expression + u8")" : expression;
+}
+
+std::u8string ProgramGenerator::generateNumber(int max) {
+    return toRomanConverter(static_cast<int>(random(max)) + 1);
+}
+
+std::u8string ProgramGenerator::newVariableName(const char* prefix) {
+    return toU8(prefix + std::to_string(m_variableCounter++));
+}
+
+size_t ProgramGenerator::random(size_t max) {
+    return std::uniform_int_distribution<size_t>(0, max - 1)(m_random);
+}
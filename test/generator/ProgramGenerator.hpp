@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <random>
+#include <filesystem>
+
+// Knobs of generated program, every combination produces valid LoremScriptum
+struct GeneratorOptions {
+    size_t functionCount = 10;
+    size_t nestingDepth = 2;     // nested si/∑ blocks in every function
+    size_t expressionLength = 4; // operands of every arithmetic expression
+    size_t includeFanOut = 0;    // functions and structs are spread over this many included files, 0 means single file
+    size_t structCount = 1;
+    size_t arrayCount = 1;       // arrays declared in every function
+    unsigned int seed = 1;       // same seed and options produce same program
+};
+
+/// @brief Generates synthetic programs of configurable scale for benchmarks and stress tests
+class ProgramGenerator {
+private:
+    GeneratorOptions m_options;
+    std::mt19937 m_random;
+    size_t m_variableCounter;
+
+public:
+    ProgramGenerator(const GeneratorOptions& options);
+
+    /// @brief whole program in one source code (includeFanOut is ignored)
+    std::u8string generate();
+
+    /// @brief writes main.lorem and includeFanOut unit files into directory
+    /// @return path of main.lorem
+    std::filesystem::path writeFiles(const std::filesystem::path& directory);
+
+private:
+    /// @brief structs and functions of unit-th of unitCount equal parts of the program
+    std::u8string generateUnit(size_t unit, size_t unitCount);
+    std::u8string generateCalls();
+
+    std::u8string generateFunction(size_t index, size_t firstFunctionOfUnit, const std::vector<std::u8string>& structNames);
+    void generateBlock(std::u8string& outCode, size_t depth, const std::u8string& indent, std::vector<std::u8string> operands);
+    std::u8string generateExpression(const std::vector<std::u8string>& operands);
+    std::u8string generateNumber(int max);
+
+    std::u8string newVariableName(const char* prefix);
+    size_t random(size_t max);
+};
@@ -0,0 +1,78 @@
+#include "ProgramGenerator.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static void printHelp() {
+    std::cout << "Usage: lscGen [options] <output>\n"
+        << "Writes synthetic LoremScriptum program to output file, or to output directory, if --include-fan-out is set\n\n"
+        << "Options:\n"
+        << "\t--functions=<N>           number of functions (default: 10)\n"
+        << "\t--depth=<N>               nested si/∑ blocks in every function (default: 2)\n"
+        << "\t--expression-length=<N>   operands of every expression (default: 4)\n"
+        << "\t--include-fan-out=<N>     spread program over N included files (default: 0)\n"
+        << "\t--structs=<N>             number of structs (default: 1)\n"
+        << "\t--arrays=<N>              arrays in every function (default: 1)\n"
+        << "\t--seed=<N>                random seed (default: 1)\n";
+}
+
+/// @brief parses "--name=N" into outValue
+static bool parseOption(const char* arg, const char* name, size_t* outValue) {
+    const size_t nameLength = std::strlen(name);
+    if (std::strncmp(arg, name, nameLength) != 0 || arg[nameLength] != '=') {
+        return false;
+    }
+    *outValue = std::strtoull(arg + nameLength + 1, nullptr, 10);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    GeneratorOptions options;
+    std::filesystem::path outputPath;
+
+    for (int i = 1; i < argc; i++) {
+        size_t seed = options.seed;
+        if (parseOption(argv[i], "--functions", &options.functionCount)
+            || parseOption(argv[i], "--depth", &options.nestingDepth)
+            || parseOption(argv[i], "--expression-length", &options.expressionLength)
+            || parseOption(argv[i], "--include-fan-out", &options.includeFanOut)
+            || parseOption(argv[i], "--structs", &options.structCount)
+            || parseOption(argv[i], "--arrays", &options.arrayCount)) {
+            continue;
+        }
+        if (parseOption(argv[i], "--seed", &seed)) {
+            options.seed = static_cast<unsigned int>(seed);
+            continue;
+        }
+        if (std::strcmp(argv[i], "--help") == 0) {
+            printHelp();
+            return 0;
+        }
+        if (argv[i][0] == '-') {
+            std::cerr << "Error: Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+        outputPath = argv[i];
+    }
+
+    if (outputPath.empty()) {
+        printHelp();
+        return 1;
+    }
+
+    ProgramGenerator generator = ProgramGenerator(options);
+    if (options.includeFanOut > 0) {
+        std::cout << generator.writeFiles(outputPath).string() << std::endl;
+        return 0;
+    }
+
+    std::u8string sourceCode = generator.generate();
+    std::ofstream outputFile(outputPath, std::ios::binary);
+    if (!outputFile) {
+        std::cerr << "Error: Couldn't open " << outputPath.string() << std::endl;
+        return 1;
+    }
+    outputFile.write(reinterpret_cast<const char*>(sourceCode.data()), sourceCode.size());
+    return 0;
+}